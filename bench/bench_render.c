@@ -0,0 +1,245 @@
+// render path benchmark, no gpu or display needed
+//
+// offscreen (or dummy) video driver + software renderer, synthetic scenes of
+// N enemies/bullets/damage numbers, times Game_Render + present per frame.
+// build like bench_sim.c (it includes game.c too):
+//
+//   cc -O2 -Imark bench/bench_render.c mark/scores.c mark/collide.c mark/jobs.c mark/kernels.c mark/grid.c mark/flow.c mark/tiles.c mark/stream.c mark/timers.c mark/events.c -lSDL3 -o mark_bench_render
+//
+//   mark_bench_render [--counts 32,256,2048,16384,50000] [--frames 300] [--seed 1]
+//                     [--world 1] [--out bench_render.json]
+//
+// --world N spreads the scene over N x N screens with the camera on the
+// player, frame cost should follow what's on screen, not the count
+
+#include <SDL3/SDL.h>
+
+// every render call game.c makes goes through here first, so draw calls
+// can be counted without touching the game code
+static int drawCalls;
+#define SDL_RenderFillRect(...)        (drawCalls++, SDL_RenderFillRect(__VA_ARGS__))
+#define SDL_RenderFillRects(...)       (drawCalls++, SDL_RenderFillRects(__VA_ARGS__))
+#define SDL_RenderRect(...)            (drawCalls++, SDL_RenderRect(__VA_ARGS__))
+#define SDL_RenderDebugText(...)       (drawCalls++, SDL_RenderDebugText(__VA_ARGS__))
+#define SDL_RenderDebugTextFormat(...) (drawCalls++, SDL_RenderDebugTextFormat(__VA_ARGS__))
+
+#include "../mark/game.c"
+#include <math.h>
+
+#define BENCH_MAX_COUNTS 16
+#define BENCH_W 800
+#define BENCH_H 600
+
+typedef struct {
+    int count;
+    int frames;
+    double snapMs;                  // Game_Snapshot
+    double meanMs, stddevMs, minMs; // Game_Render + present
+    double drawCalls;               // per frame
+    int rects;                      // per frame
+} Result;
+
+static Game game;
+static GameView view;
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// world 1 = everything on screen, so nothing is culled by the window edges
+static void scene(Game* g, int n, Uint64 seed)
+{
+    srand((unsigned)seed);
+
+    Game_Reserve(g, n, n, n);
+    reset_run(g);
+    g->state = GAME_PLAY;
+    g->kills = 123;
+
+    for (int i = 0; i < n; i++) {
+        Enemy* e = &g->enemies[i];
+        init_enemy_by_type(e, (EnemyType)(rand() % 4));
+        e->x = frand(0.0f, g->worldW - e->size);
+        e->y = frand(0.0f, g->worldH - e->size);
+        if (e->type == ENEMY_ARCHER && rand() % 4 == 0) e->windup = true;
+    }
+
+    // half player bullets, half enemy bullets
+    for (int i = 0; i < n / 2; i++) {
+        Bullet* b = &g->bullets[i];
+        b->alive = true;
+        b->x = frand(0.0f, g->worldW);
+        b->y = frand(0.0f, g->worldH);
+
+        float ex = frand(0.0f, g->worldW);
+        float ey = frand(0.0f, g->worldH);
+        spawn_enemy_bullet(g, ex, ey, 1.0f, 0.0f, 0.0f, 10);
+    }
+
+    for (int i = 0; i < n && i < MAX_DMG_NUMS; i++)
+        spawn_dmg(g, (Uint32)i + 1, 0, frand(0.0f, g->worldW), frand(0.0f, g->worldH), (rand() % 2) ? 25 : -14);
+
+    // the snapshot culls enemies through the grid a tick would have built
+    index_enemies(g);
+}
+
+static double ticks_to_ms(Uint64 t)
+{
+    return (double)t * 1e3 / (double)SDL_GetPerformanceFrequency();
+}
+
+static void measure(SDL_Renderer* r, int n, int frames, Uint64 seed, Result* res)
+{
+    scene(&game, n, seed);
+
+    Uint64 snapTicks = 0;
+    double sum = 0.0, sumSq = 0.0, best = 1e30;
+    long long calls = 0;
+
+    // a few frames to warm caches and the renderer's buffers
+    int warm = frames / 10 + 1;
+
+    for (int f = 0; f < warm + frames; f++) {
+        Uint64 t0 = SDL_GetPerformanceCounter();
+        Game_Snapshot(&game, &view);
+        Uint64 t1 = SDL_GetPerformanceCounter();
+
+        drawCalls = 0;
+        SDL_SetRenderDrawColor(r, 15, 15, 18, 255);
+        SDL_RenderClear(r);
+        Game_Render(&view, r);
+        SDL_RenderPresent(r);
+        Uint64 t2 = SDL_GetPerformanceCounter();
+
+        if (f < warm) continue;
+
+        double ms = ticks_to_ms(t2 - t1);
+        snapTicks += t1 - t0;
+        sum += ms;
+        sumSq += ms * ms;
+        if (ms < best) best = ms;
+        calls += drawCalls;
+    }
+
+    double mean = sum / frames;
+    double var = (frames > 1) ? (sumSq - sum * mean) / (frames - 1) : 0.0;
+
+    res->count = n;
+    res->frames = frames;
+    res->snapMs = ticks_to_ms(snapTicks) / frames;
+    res->meanMs = mean;
+    res->stddevMs = (var > 0.0) ? sqrt(var) : 0.0;
+    res->minMs = best;
+    res->drawCalls = (double)calls / frames;
+    res->rects = view.rectCount;
+}
+
+static void write_json(const char* path, const Result* res, int count, const char* driver, const char* renderer,
+                       Uint64 seed, int world)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        SDL_Log("can't write %s", path);
+        return;
+    }
+
+    fprintf(f, "{\n  \"seed\": %llu,\n  \"video\": \"%s\",\n  \"renderer\": \"%s\",\n  \"size\": [%d, %d],\n  \"world\": %d,\n  \"results\": [\n",
+        (unsigned long long)seed, driver, renderer, BENCH_W, BENCH_H, world);
+    for (int i = 0; i < count; i++) {
+        const Result* r = &res[i];
+        fprintf(f, "    {\"bench\": \"render\", \"count\": %d, \"frames\": %d, \"ms_per_frame\": %.4f, \"stddev_ms\": %.4f, "
+            "\"min_ms\": %.4f, \"snapshot_ms\": %.4f, \"draw_calls\": %.1f, \"rects\": %d}%s\n",
+            r->count, r->frames, r->meanMs, r->stddevMs, r->minMs, r->snapMs, r->drawCalls, r->rects,
+            (i + 1 < count) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+static int parse_counts(const char* s, int* out)
+{
+    int n = 0;
+    while (*s && n < BENCH_MAX_COUNTS) {
+        int v = atoi(s);
+        if (v > 0) out[n++] = v;
+        while (*s && *s != ',') s++;
+        if (*s == ',') s++;
+    }
+    return n;
+}
+
+int main(int argc, char* argv[])
+{
+    int counts[BENCH_MAX_COUNTS] = { 32, 256, 2048, 16384, 50000 };
+    int countN = 5;
+    int frames = 300;
+    Uint64 seed = 1;
+    int world = 1;
+    const char* out = "bench_render.json";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* a = argv[i];
+        const char* v = argv[i + 1];
+        if      (strcmp(a, "--counts") == 0) countN = parse_counts(v, counts);
+        else if (strcmp(a, "--frames") == 0) frames = atoi(v);
+        else if (strcmp(a, "--seed") == 0)   seed = (Uint64)strtoull(v, NULL, 10);
+        else if (strcmp(a, "--world") == 0)  world = SDL_clamp(atoi(v), 1, 64);
+        else if (strcmp(a, "--out") == 0)    out = v;
+    }
+    if (frames < 1) frames = 1;
+
+    // offscreen first, dummy if this SDL build doesn't have it
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        SDL_Log("SDL_Init failed: %s", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Window* window = SDL_CreateWindow("mark bench", BENCH_W, BENCH_H, SDL_WINDOW_HIDDEN);
+    if (!window) {
+        SDL_Log("SDL_CreateWindow failed: %s", SDL_GetError());
+        SDL_Quit();
+        return 2;
+    }
+
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, SDL_SOFTWARE_RENDERER);
+    if (!renderer) {
+        SDL_Log("SDL_CreateRenderer failed: %s", SDL_GetError());
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 3;
+    }
+    SDL_SetRenderVSync(renderer, 0);
+
+    const char* driver = SDL_GetCurrentVideoDriver();
+    const char* rname = SDL_GetRendererName(renderer);
+
+    Game_Init(&game, (float)(BENCH_W * world), (float)(BENCH_H * world));
+    Game_SetView(&game, (float)BENCH_W, (float)BENCH_H);
+    // bench never ends a run, so nothing gets written to the score file
+    game.p.hpMax = game.p.hp = 1 << 30;
+
+    printf("video %s, renderer %s, %dx%d, world %dx%d\n", driver ? driver : "?", rname ? rname : "?",
+        BENCH_W, BENCH_H, BENCH_W * world, BENCH_H * world);
+    printf("%8s %10s %10s %10s %12s %10s\n", "count", "ms/frame", "stddev", "min", "snapshot ms", "calls");
+
+    static Result results[BENCH_MAX_COUNTS];
+    for (int c = 0; c < countN; c++) {
+        Result* r = &results[c];
+        measure(renderer, counts[c], frames, seed, r);
+        printf("%8d %10.3f %10.3f %10.3f %12.3f %10.1f\n",
+            r->count, r->meanMs, r->stddevMs, r->minMs, r->snapMs, r->drawCalls);
+        fflush(stdout);
+    }
+
+    write_json(out, results, countN, driver ? driver : "?", rname ? rname : "?", seed, world);
+    printf("written to %s\n", out);
+
+    GameView_Free(&view);
+    Game_Shutdown(&game);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
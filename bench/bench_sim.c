@@ -0,0 +1,724 @@
+// microbenchmarks for the simulation hot paths
+//
+// pulls game.c in directly so the static helpers (spawn_enemy, fire_bullet, ...)
+// can be timed on their own. build it from every mark/*.c except main.c and game.c:
+//
+//   cc -O2 -Imark bench/bench_sim.c mark/scores.c mark/collide.c mark/jobs.c mark/kernels.c mark/grid.c mark/flow.c mark/tiles.c mark/stream.c mark/timers.c mark/events.c -lSDL3 -o mark_bench
+//
+//   mark_bench [--counts 32,256,2048,16384,50000] [--samples 10] [--budget 2] [--seed 1]
+//              [--out bench_sim.json] [--baseline old.json] [--threshold 10] [--only name]
+//              [--kernels scalar|sse4.1|avx2] [--exact 1]
+//
+// every scenario is rebuilt from the seed, so two runs of the same build only
+// differ by timing noise. --baseline compares means against an earlier json and
+// exits with 1 when something got slower than --threshold percent.
+
+#include "../mark/game.c"
+#include <math.h>
+
+#define BENCH_MAX_COUNTS  16
+#define BENCH_MAX_SAMPLES 64
+#define BENCH_MAX_ITERS   (1 << 16)
+#define BENCH_SAMPLE_NS   2e6       // a sample runs at least this long
+
+typedef struct {
+    Game g;
+    int n;
+    Uint64 seed;
+    ContactList hits;
+    GameInput input;
+
+    // scenario as built, restored before every timed op
+    Enemy* enemies0;
+    Bullet* bullets0;
+    EBulletPool eb0;
+    DamageNum dmgnums0[MAX_DMG_NUMS];
+    int dmgCount0;
+    Player p0;
+    float spawnTimer0;
+} Bench;
+
+typedef struct {
+    const char* name;
+    const char* op;                         // what one op is
+    void (*setup)(Bench* b, int n);
+    double (*run)(Bench* b);                // returns ops done
+} BenchDef;
+
+typedef struct {
+    const char* name;
+    const char* op;
+    int count;
+    int samples;
+    int iters;
+    double mean, var, stddev, min, median;  // ns per op
+} Result;
+
+static Bench bench;
+static double timerOverhead;   // ns, one empty timed region
+
+/* ------------------ scenario ------------------ */
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// live prefix only, the pool stays packed
+static void copy_ebullets(EBulletPool* dst, const EBulletPool* src)
+{
+    size_t n = (size_t)src->count;
+    SDL_memcpy(dst->x, src->x, n * sizeof(float));
+    SDL_memcpy(dst->y, src->y, n * sizeof(float));
+    SDL_memcpy(dst->px, src->px, n * sizeof(float));
+    SDL_memcpy(dst->py, src->py, n * sizeof(float));
+    SDL_memcpy(dst->vx, src->vx, n * sizeof(float));
+    SDL_memcpy(dst->vy, src->vy, n * sizeof(float));
+    SDL_memcpy(dst->dmg, src->dmg, n * sizeof(int));
+    SDL_memcpy(dst->alive, src->alive, n * sizeof(bool));
+    dst->count = src->count;
+}
+
+// world grows with the count so density stays about the same
+static void scene(Bench* b, int n, int enemies, int bullets, int ebullets, int enemyType)
+{
+    Game* g = &b->g;
+    srand((unsigned)b->seed);
+
+    float s = SDL_sqrtf((float)n / 128.0f);
+    if (s < 1.0f) s = 1.0f;
+    g->worldW = 800.0f * s;
+    g->worldH = 600.0f * s;
+    Tiles_Free(&g->tiles);    // open arena unless a bench adds walls
+
+    Game_Reserve(g, n, n, n);
+    reset_run(g);
+    g->state = GAME_PLAY;
+    g->mode = MODE_ARCADE;
+
+    // never dies (no score writes) and never runs dry
+    g->p.hpMax = g->p.hp = 1 << 30;
+    g->p.magMax = g->p.mag = 1 << 30;
+    g->p.x = g->p.px = g->worldW * 0.5f;
+    g->p.y = g->p.py = g->worldH * 0.5f;
+
+    for (int i = 0; i < enemies && i < n; i++) {
+        Enemy* e = &g->enemies[i];
+        int t = (enemyType >= 0) ? enemyType : rand() % 4;
+        init_enemy_by_type(e, (EnemyType)t);
+        e->x = e->px = frand(0.0f, g->worldW - e->size);
+        e->y = e->py = frand(0.0f, g->worldH - e->size);
+        e->rng = b->seed * 0x9E3779B97F4A7C15ull + (Uint64)i;
+    }
+
+    for (int i = 0; i < bullets && i < n; i++) {
+        Bullet* bl = &g->bullets[i];
+        float a = frand(0.0f, 6.2831853f);
+        bl->alive = true;
+        bl->x = bl->px = frand(0.0f, g->worldW);
+        bl->y = bl->py = frand(0.0f, g->worldH);
+        bl->vx = SDL_cosf(a) * 900.0f;
+        bl->vy = SDL_sinf(a) * 900.0f;
+        bl->r = 4.0f;
+    }
+
+    for (int i = 0; i < ebullets && i < n; i++) {
+        float a = frand(0.0f, 6.2831853f);
+        float x = frand(0.0f, g->worldW);
+        float y = frand(0.0f, g->worldH);
+        spawn_enemy_bullet(g, x, y, SDL_cosf(a), SDL_sinf(a), 470.0f, 10);
+    }
+
+    b->n = n;
+    g->spawnTimer = 1e9f;
+
+    // the whole scene is on screen, game_update runs every enemy at full detail
+    Game_SetView(g, g->worldW, g->worldH);
+
+    // keep a copy for reset
+    SDL_free(b->enemies0);
+    SDL_free(b->bullets0);
+    free_ebullets(&b->eb0);
+    b->enemies0 = (Enemy*)SDL_malloc((size_t)n * sizeof(Enemy));
+    b->bullets0 = (Bullet*)SDL_malloc((size_t)n * sizeof(Bullet));
+    alloc_ebullets(&b->eb0, n);
+    SDL_memcpy(b->enemies0, g->enemies, (size_t)n * sizeof(Enemy));
+    SDL_memcpy(b->bullets0, g->bullets, (size_t)n * sizeof(Bullet));
+    copy_ebullets(&b->eb0, &g->eb);
+    SDL_memcpy(b->dmgnums0, g->dmgnums, sizeof(b->dmgnums0));
+    b->dmgCount0 = g->dmgCount;
+    b->p0 = g->p;
+    b->spawnTimer0 = g->spawnTimer;
+}
+
+static void reset(Bench* b)
+{
+    Game* g = &b->g;
+    SDL_memcpy(g->enemies, b->enemies0, (size_t)b->n * sizeof(Enemy));
+    SDL_memcpy(g->bullets, b->bullets0, (size_t)b->n * sizeof(Bullet));
+    copy_ebullets(&g->eb, &b->eb0);
+    SDL_memcpy(g->dmgnums, b->dmgnums0, sizeof(b->dmgnums0));
+    g->dmgCount = b->dmgCount0;
+    g->p = b->p0;
+    g->spawnTimer = b->spawnTimer0;
+    g->kills = 0;
+    g->state = GAME_PLAY;
+}
+
+// half the slots taken at random, spawn/fire have to scan for a free one
+static void half_alive(Bench* b, int n, bool enemies)
+{
+    scene(b, n, enemies ? n : 0, enemies ? 0 : n, 0, -1);
+
+    Game* g = &b->g;
+    for (int i = 0; i < n; i++) {
+        if (rand() % 2) continue;
+        if (enemies) g->enemies[i].alive = false;
+        else         g->bullets[i].alive = false;
+    }
+    SDL_memcpy(b->enemies0, g->enemies, (size_t)n * sizeof(Enemy));
+    SDL_memcpy(b->bullets0, g->bullets, (size_t)n * sizeof(Bullet));
+}
+
+/* ------------------ benchmarks ------------------ */
+
+static void setup_spawn(Bench* b, int n)  { half_alive(b, n, true); }
+static void setup_fire(Bench* b, int n)   { half_alive(b, n, false); }
+static void setup_bullets(Bench* b, int n) { scene(b, n, 0, n, 0, -1); }
+static void setup_chase(Bench* b, int n)   { scene(b, n, n, 0, 0, ENEMY_GRUNT); }
+static void setup_ebullets(Bench* b, int n) { scene(b, n, 0, 0, n, -1); }
+static void setup_far(Bench* b, int n)     { scene(b, n, n, 0, 0, -1); }
+
+// cooldowns already up, the ones in sight start a windup
+static void setup_archers(Bench* b, int n)
+{
+    scene(b, n, n, 0, 0, ENEMY_ARCHER);
+
+    Game* g = &b->g;
+    for (int i = 0; i < n; i++) g->enemies[i].shootReady = true;
+    SDL_memcpy(b->enemies0, g->enemies, (size_t)n * sizeof(Enemy));
+}
+
+// detect reads the packed copies, nothing in the timed part changes them
+static void setup_collide(Bench* b, int n)
+{
+    scene(b, n, n, n, 0, -1);
+    Contacts_Pack(&b->g);
+}
+static void setup_tick(Bench* b, int n)    { scene(b, n, n, n, n, -1); }
+
+// bullet-hell scene: a pool of n enemy bullets kept topped up by emitters
+static void setup_stress(Bench* b, int n)
+{
+    int emitters = SDL_min(n, STRESS_ENEMIES);
+    scene(b, n, emitters, 0, n, -1);
+
+    // player bullet cap as in the real mode, the array itself stays n long
+    Game* g = &b->g;
+    g->mode = MODE_STRESS;
+    g->maxBullets = SDL_min(n, STRESS_BULLETS);
+    for (int i = 0; i < emitters; i++) {
+        Enemy* e = &g->enemies[i];
+        init_enemy_by_type(e, (i % 2) ? ENEMY_TANK : ENEMY_ARCHER);
+        e->x = e->px = frand(0.0f, g->worldW - e->size);
+        e->y = e->py = frand(0.0f, g->worldH - e->size);
+        e->rng = b->seed * 0x9E3779B97F4A7C15ull + (Uint64)i;
+        init_emitter(e);
+    }
+    SDL_memcpy(b->enemies0, g->enemies, (size_t)n * sizeof(Enemy));
+}
+
+// pillar field over the whole world, every route to the player bends around something
+static void add_pillars(Bench* b)
+{
+    TileMap* t = &b->g.tiles;
+    t->tile = TILE_SIZE;
+    t->cols = (int)(b->g.worldW / TILE_SIZE) + 1;
+    t->rows = (int)(b->g.worldH / TILE_SIZE) + 1;
+    t->solid = (Uint8*)SDL_calloc((size_t)(t->cols * t->rows), 1);
+    t->walls = 0;
+    for (int r = 2; r < t->rows; r += 5)
+        for (int c = 2 + (r / 5) % 3; c < t->cols; c += 6) {
+            t->solid[r * t->cols + c] = 1;
+            if (c + 1 < t->cols) t->solid[r * t->cols + c + 1] = 1;
+            if (r + 1 < t->rows) t->solid[(r + 1) * t->cols + c] = 1;
+            t->walls += 3;
+        }
+}
+
+static void setup_flow(Bench* b, int n)
+{
+    scene(b, n, 0, 0, 0, -1);
+    add_pillars(b);
+}
+
+static void setup_sight(Bench* b, int n)
+{
+    scene(b, n, n, 0, 0, ENEMY_ARCHER);
+    add_pillars(b);
+}
+
+static void setup_walls(Bench* b, int n)
+{
+    scene(b, n, n, 0, 0, -1);
+    add_pillars(b);
+}
+
+// every archer on the wheel: first shot (fires once) and strafe turns (every ~0.9 s)
+static void setup_timers(Bench* b, int n)
+{
+    scene(b, n, n, 0, 0, ENEMY_ARCHER);
+    for (int i = 0; i < n; i++) start_enemy_timers(&b->g, &b->g.enemies[i]);
+    SDL_memcpy(b->enemies0, b->g.enemies, (size_t)n * sizeof(Enemy));
+}
+
+// single calls are shorter than the timer, so a batch fills an eighth of the
+// pool (half of it is free after setup)
+static int fill_batch(int n)
+{
+    int k = n / 8;
+    if (k < 8) k = 8;
+    if (k > n / 2) k = n / 2;
+    return (k > 0) ? k : 1;
+}
+
+static double run_spawn(Bench* b)
+{
+    int k = fill_batch(b->n);
+    for (int i = 0; i < k; i++) spawn_enemy(&b->g);
+    return (double)k;
+}
+
+static double run_fire(Bench* b)
+{
+    int k = fill_batch(b->n);
+    for (int i = 0; i < k; i++) fire_bullet(&b->g, b->g.p.x, b->g.p.y, 1.0f, 0.0f, 0.0f);
+    return (double)k;
+}
+
+// near rect over the whole scene, like Game_Update's around the camera,
+// so passes timed on their own don't treat everyone as off screen
+static void near_all(const Game* g, PassCtx* c)
+{
+    c->nearX0 = -LOD_MARGIN;
+    c->nearY0 = -LOD_MARGIN;
+    c->nearX1 = g->worldW + LOD_MARGIN;
+    c->nearY1 = g->worldH + LOD_MARGIN;
+}
+
+static double run_bullets(Bench* b)
+{
+    PassCtx c = { .g = &b->g, .dt = 1.0f / 60.0f, .count = b->n, .per = b->n, .chunks = 1 };
+    job_bullets(&c, 0);
+    return (double)b->n;
+}
+
+static double run_ebullets(Bench* b)
+{
+    PassCtx c = { .g = &b->g, .dt = 1.0f / 60.0f, .count = b->g.eb.count, .per = b->g.eb.count, .chunks = 1 };
+    job_ebullets(&c, 0);
+    return (double)b->g.eb.count;
+}
+
+static double run_enemies(Bench* b)
+{
+    Game* g = &b->g;
+    PassCtx c = {
+        .g = g, .dt = 1.0f / 60.0f,
+        .pcx = g->p.x + g->p.size * 0.5f, .pcy = g->p.y + g->p.size * 0.5f,
+        .count = b->n, .per = b->n, .chunks = 1
+    };
+    near_all(g, &c);
+    job_move_enemies(&c, 0);
+    return (double)b->n;
+}
+
+// mixed types all past the near rect with AI LOD on, one tick of its stagger.
+// the near rect stays empty, nobody is on screen
+static double run_far(Bench* b)
+{
+    Game* g = &b->g;
+    PassCtx c = {
+        .g = g, .dt = 1.0f / 60.0f,
+        .pcx = g->p.x + g->p.size * 0.5f, .pcy = g->p.y + g->p.size * 0.5f,
+        .aiPeriod = ai_period(b->n), .aiTick = g->aiTick++,
+        .count = b->n, .per = b->n, .chunks = 1
+    };
+    job_move_enemies(&c, 0);
+    return (double)b->n;
+}
+
+// same chase, plus the grid build and separation a real tick does
+static double run_crowd(Bench* b)
+{
+    Game* g = &b->g;
+    Enemy* e0 = &g->enemies[0];
+    PassCtx c = {
+        .g = g, .dt = 1.0f / 60.0f,
+        .pcx = g->p.x + g->p.size * 0.5f, .pcy = g->p.y + g->p.size * 0.5f,
+        .count = b->n, .per = b->n, .chunks = 1
+    };
+    near_all(g, &c);
+    c.crowd = Grid_Build(&g->crowd, CROWD_CELL, 0.0f, 0.0f, g->worldW, g->worldH,
+                         &e0->x, &e0->y, &e0->size, &e0->alive, sizeof(Enemy), b->n);
+    job_move_enemies(&c, 0);
+    return (double)b->n;
+}
+
+// forced full rebuild, what a player crossing into a new cell costs
+static double run_flow(Bench* b)
+{
+    Game* g = &b->g;
+    g->flow.goal = -1;
+    Flow_Update(&g->flow, FLOW_CELL, 0.0f, 0.0f, g->worldW, g->worldH, g->tiles.solid, 0.0f,
+                g->p.x + g->p.size * 0.5f, g->p.y + g->p.size * 0.5f);
+    return (double)(g->flow.cols * g->flow.rows);
+}
+
+// every archer due a check at once, the worst tick of the LOS_TICKS cycle
+static double run_sight(Bench* b)
+{
+    Game* g = &b->g;
+    PassCtx c = {
+        .g = g, .dt = 1.0f / 60.0f,
+        .pcx = g->p.x + g->p.size * 0.5f, .pcy = g->p.y + g->p.size * 0.5f,
+        .count = b->n, .per = b->n, .chunks = 1
+    };
+    near_all(g, &c);
+    job_archer_los(&c, 0);
+    return (double)b->n;
+}
+
+// every enemy tries a step and gets walked through the tile grid
+static double run_walls(Bench* b)
+{
+    Game* g = &b->g;
+    for (int i = 0; i < b->n; i++) {
+        Enemy* en = &g->enemies[i];
+        en->x += 3.0f;
+        en->y -= 2.0f;
+        settle_enemy(&g->tiles, en);
+    }
+    return (double)b->n;
+}
+
+static double run_collide(Bench* b)
+{
+    b->hits.count = 0;
+    Contacts_DetectEnemies(&b->g, 0, b->n, &b->hits);
+    return (double)b->n * (double)b->n;
+}
+
+static double run_ebullet_hits(Bench* b)
+{
+    b->hits.count = 0;
+    Contacts_DetectEBullets(&b->g, 0, b->g.eb.count, &b->hits);
+    return (double)b->g.eb.count;
+}
+
+// one tick of the game clock, per timer waiting on the wheel (most of them just wait)
+static double run_timers(Bench* b)
+{
+    Game* g = &b->g;
+    int waiting = g->timers.count;
+    g->clock += 1.0 / 60.0;
+    Timers_Advance(&g->timers, clock_ms(g->clock), on_timer, g);
+    return waiting ? (double)waiting : 1.0;
+}
+
+// sustained fire on a few targets over a full pool: the first hit on each
+// evicts the oldest number, the rest add to it
+#define DMG_BENCH_TARGETS 16
+
+static void setup_dmg(Bench* b, int n)
+{
+    scene(b, n, n, 0, 0, -1);
+    Game* g = &b->g;
+    for (int i = 0; i < MAX_DMG_NUMS; i++)
+        spawn_dmg(g, (Uint32)(n + i + 1), 0, frand(0.0f, g->worldW), frand(0.0f, g->worldH), 25);
+    SDL_memcpy(b->dmgnums0, g->dmgnums, sizeof(b->dmgnums0));
+    b->dmgCount0 = g->dmgCount;
+}
+
+static double run_dmg(Bench* b)
+{
+    Game* g = &b->g;
+    for (int i = 0; i < b->n; i++) {
+        const Enemy* en = &g->enemies[i % DMG_BENCH_TARGETS];
+        spawn_dmg(g, (Uint32)(i % DMG_BENCH_TARGETS) + 1, en->gen, en->x, en->y, 25);
+    }
+    return (double)b->n;
+}
+
+static double run_tick(Bench* b)
+{
+    Game_Update(&b->g, &b->input, 1.0f / 60.0f);
+    return 1.0;
+}
+
+static const BenchDef BENCHES[] = {
+    { "spawn_enemy",      "call",    setup_spawn,    run_spawn },
+    { "fire_bullet",      "call",    setup_fire,     run_fire },
+    { "bullet_integrate", "bullet",  setup_bullets,  run_bullets },
+    { "ebullet_integrate","ebullet", setup_ebullets, run_ebullets },
+    { "enemy_chase",      "enemy",   setup_chase,    run_enemies },
+    { "enemy_crowd",      "enemy",   setup_chase,    run_crowd },
+    { "flow_build",       "cell",    setup_flow,     run_flow },
+    { "enemy_vs_walls",   "enemy",   setup_walls,    run_walls },
+    { "archer_los",       "archer",  setup_sight,    run_sight },
+    { "archer_ai",        "archer",  setup_archers,  run_enemies },
+    { "enemy_mixed",      "enemy",   setup_far,      run_enemies },
+    { "enemy_far_lod",    "enemy",   setup_far,      run_far },
+    { "bullet_vs_enemy",  "pair",    setup_collide,  run_collide },
+    { "ebullet_vs_player","ebullet", setup_ebullets, run_ebullet_hits },
+    { "timer_wheel",      "timer",   setup_timers,   run_timers },
+    { "dmg_numbers",      "hit",     setup_dmg,      run_dmg },
+    { "game_update",      "tick",    setup_tick,     run_tick },
+    { "stress_tick",      "tick",    setup_stress,   run_tick },
+};
+#define BENCH_COUNT ((int)(sizeof(BENCHES) / sizeof(BENCHES[0])))
+
+/* ------------------ runner ------------------ */
+
+static double ticks_to_ns(Uint64 t)
+{
+    return (double)t * 1e9 / (double)SDL_GetPerformanceFrequency();
+}
+
+// ns spent in the op itself over iters runs, reset is outside the timed part
+static double timed(const BenchDef* d, Bench* b, int iters, double* ops)
+{
+    Uint64 total = 0;
+    *ops = 0.0;
+    for (int i = 0; i < iters; i++) {
+        reset(b);
+        Uint64 t0 = SDL_GetPerformanceCounter();
+        *ops += d->run(b);
+        total += SDL_GetPerformanceCounter() - t0;
+    }
+
+    double ns = ticks_to_ns(total) - timerOverhead * iters;
+    return (ns > 0.0) ? ns : 0.0;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+static void measure(const BenchDef* d, int n, int maxSamples, double budgetNs, Result* r)
+{
+    Bench* b = &bench;
+    d->setup(b, n);
+
+    // smallest power of two that makes a sample long enough
+    double ops;
+    int iters = 1;
+    double first = timed(d, b, iters, &ops);
+    while (first < BENCH_SAMPLE_NS && iters < BENCH_MAX_ITERS) {
+        iters *= 2;
+        first = timed(d, b, iters, &ops);
+    }
+
+    double per[BENCH_MAX_SAMPLES];
+    int samples = 0;
+    double spent = 0.0;
+    while (samples < maxSamples) {
+        double ns = timed(d, b, iters, &ops);
+        per[samples++] = ns / ops;
+        spent += ns;
+        // slow cases (quadratic at 50k) settle for a few samples
+        if (samples >= 3 && spent > budgetNs) break;
+    }
+
+    double mean = 0.0;
+    for (int i = 0; i < samples; i++) mean += per[i];
+    mean /= samples;
+
+    double var = 0.0;
+    for (int i = 0; i < samples; i++) var += (per[i] - mean) * (per[i] - mean);
+    var = (samples > 1) ? var / (samples - 1) : 0.0;
+
+    qsort(per, (size_t)samples, sizeof(double), cmp_double);
+
+    r->name = d->name;
+    r->op = d->op;
+    r->count = n;
+    r->samples = samples;
+    r->iters = iters;
+    r->mean = mean;
+    r->var = var;
+    r->stddev = sqrt(var);
+    r->min = per[0];
+    r->median = (samples % 2) ? per[samples / 2] : 0.5 * (per[samples / 2 - 1] + per[samples / 2]);
+}
+
+static void calibrate_timer(void)
+{
+    Uint64 best = ~(Uint64)0;
+    for (int i = 0; i < 1000; i++) {
+        Uint64 t0 = SDL_GetPerformanceCounter();
+        Uint64 t1 = SDL_GetPerformanceCounter();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    timerOverhead = ticks_to_ns(best);
+}
+
+/* ------------------ json ------------------ */
+
+// one result per line, --baseline reads it back with sscanf
+static void write_json(const char* path, const Result* res, int count, int threads, Uint64 seed, const Kernels* k)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        SDL_Log("can't write %s", path);
+        return;
+    }
+
+    fprintf(f, "{\n  \"seed\": %llu,\n  \"threads\": %d,\n  \"kernels\": \"%s\",\n  \"exact\": %s,\n  \"results\": [\n",
+        (unsigned long long)seed, threads, Kernels_Name(k->level), k->exact ? "true" : "false");
+    for (int i = 0; i < count; i++) {
+        const Result* r = &res[i];
+        fprintf(f, "    {\"bench\": \"%s\", \"count\": %d, \"op\": \"%s\", \"samples\": %d, \"iters\": %d, "
+            "\"mean_ns\": %.3f, \"var_ns2\": %.3f, \"stddev_ns\": %.3f, \"min_ns\": %.3f, \"median_ns\": %.3f}%s\n",
+            r->name, r->count, r->op, r->samples, r->iters,
+            r->mean, r->var, r->stddev, r->min, r->median, (i + 1 < count) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+static bool baseline_mean(const char* path, const char* name, int count, double* mean)
+{
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[512];
+    bool found = false;
+    while (!found && fgets(line, (int)sizeof(line), f)) {
+        char bname[64];
+        int bcount;
+        double bmean;
+        const char* at = strstr(line, "{\"bench\"");
+        if (!at) continue;
+        if (sscanf(at, "{\"bench\": \"%63[^\"]\", \"count\": %d, \"op\": \"%*[^\"]\", \"samples\": %*d, \"iters\": %*d, \"mean_ns\": %lf",
+                   bname, &bcount, &bmean) != 3)
+            continue;
+        if (bcount == count && strcmp(bname, name) == 0) {
+            *mean = bmean;
+            found = true;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+/* ------------------ main ------------------ */
+
+static int parse_counts(const char* s, int* out)
+{
+    int n = 0;
+    while (*s && n < BENCH_MAX_COUNTS) {
+        int v = atoi(s);
+        if (v > 0) out[n++] = v;
+        while (*s && *s != ',') s++;
+        if (*s == ',') s++;
+    }
+    return n;
+}
+
+int main(int argc, char* argv[])
+{
+    int counts[BENCH_MAX_COUNTS] = { 32, 256, 2048, 16384, 50000 };
+    int countN = 5;
+    int samples = 10;
+    double budget = 2.0;
+    Uint64 seed = 1;
+    const char* out = "bench_sim.json";
+    const char* baseline = NULL;
+    double threshold = 10.0;
+    const char* only = NULL;
+    KernelLevel kernels = KERNEL_AVX2;
+    bool exact = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!v) break;
+        if      (strcmp(a, "--counts") == 0)    { countN = parse_counts(v, counts); i++; }
+        else if (strcmp(a, "--samples") == 0)   { samples = atoi(v); i++; }
+        else if (strcmp(a, "--budget") == 0)    { budget = atof(v); i++; }
+        else if (strcmp(a, "--seed") == 0)      { seed = (Uint64)strtoull(v, NULL, 10); i++; }
+        else if (strcmp(a, "--out") == 0)       { out = v; i++; }
+        else if (strcmp(a, "--baseline") == 0)  { baseline = v; i++; }
+        else if (strcmp(a, "--threshold") == 0) { threshold = atof(v); i++; }
+        else if (strcmp(a, "--only") == 0)      { only = v; i++; }
+        else if (strcmp(a, "--exact") == 0)     { exact = atoi(v) != 0; i++; }
+        else if (strcmp(a, "--kernels") == 0) {
+            if      (strcmp(v, "scalar") == 0) kernels = KERNEL_SCALAR;
+            else if (strcmp(v, "sse4.1") == 0) kernels = KERNEL_SSE41;
+            i++;
+        }
+    }
+    if (samples < 3) samples = 3;
+    if (samples > BENCH_MAX_SAMPLES) samples = BENCH_MAX_SAMPLES;
+
+    if (!SDL_Init(0)) {
+        SDL_Log("SDL_Init failed: %s", SDL_GetError());
+        return 1;
+    }
+
+    calibrate_timer();
+
+    Bench* b = &bench;
+    b->seed = seed;
+    Game_Init(&b->g, 800.0f, 600.0f);
+    Kernels_Select(&b->g.kern, kernels, exact);
+
+    // full tick: holding fire and strafing, aim at the far corner
+    b->input.keys[SDL_SCANCODE_LCTRL] = true;
+    b->input.keys[SDL_SCANCODE_D] = true;
+    b->input.mouseX = 1e6f;
+    b->input.mouseY = 1e6f;
+
+    int threads = Jobs_Threads(b->g.jobs);
+    printf("%-18s %8s %10s %12s %10s %10s\n", "bench", "count", "op", "ns/op", "stddev", "min");
+
+    static Result results[BENCH_COUNT * BENCH_MAX_COUNTS];
+    int resultN = 0;
+    int regressions = 0;
+
+    for (int d = 0; d < BENCH_COUNT; d++) {
+        if (only && strcmp(only, BENCHES[d].name) != 0) continue;
+
+        for (int c = 0; c < countN; c++) {
+            Result* r = &results[resultN++];
+            measure(&BENCHES[d], counts[c], samples, budget * 1e9, r);
+
+            printf("%-18s %8d %10s %12.2f %10.2f %10.2f", r->name, r->count, r->op, r->mean, r->stddev, r->min);
+
+            double base;
+            if (baseline && baseline_mean(baseline, r->name, r->count, &base) && base > 0.0) {
+                double pct = (r->mean - base) / base * 100.0;
+                bool worse = pct > threshold;
+                regressions += worse;
+                printf("  %+7.1f%%%s", pct, worse ? "  REGRESSION" : "");
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    write_json(out, results, resultN, threads, seed, &b->g.kern);
+    printf("%d results, %d thread(s), %s kernels, written to %s\n", resultN, threads, Kernels_Name(b->g.kern.level), out);
+
+    Contacts_Free(&b->hits);
+    SDL_free(b->enemies0);
+    SDL_free(b->bullets0);
+    free_ebullets(&b->eb0);
+    Game_Shutdown(&b->g);
+    SDL_Quit();
+
+    return regressions ? 1 : 0;
+}
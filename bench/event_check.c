@@ -0,0 +1,197 @@
+// event ring with readers on other threads than the writer
+//
+// a writer thread pushes --events numbered events in steps of random size
+// (publish at the end of each, like the sim) while two readers call
+// Events_Read on their own threads: one keeps up, one stalls now and then
+// so the writer laps it, also in the middle of a copy. every event read has
+// to be whole (all fields from the same push), in order with nothing
+// skipped that isn't counted in dropped, and read + dropped has to add up
+// to everything pushed.
+//
+//   cc -O2 -Imark bench/event_check.c mark/events.c -lSDL3 -o mark_event_check
+//
+//   mark_event_check [--events 20000000] [--seed 1]
+//
+// exits with 1 on a torn, reordered or miscounted event
+
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "events.h"
+
+typedef struct {
+    Uint64 state;
+} Rng;
+
+static Uint32 next_u32(Rng* r)
+{
+    r->state = r->state * 6364136223846793005ull + 1442695040888963407ull;
+    return (Uint32)(r->state >> 33);
+}
+
+// every field from the sequence number, a mix of two pushes can't pass
+static void make_event(Uint32 seq, GameEvent* e)
+{
+    e->type = (EventType)(seq % 5);
+    e->id = (int)seq;
+    e->gen = seq * 2654435761u;
+    e->value = (int)~seq;
+    e->x = (float)(seq & 0xFFFF);
+    e->y = (float)(seq >> 16);
+}
+
+static bool whole(const GameEvent* e, Uint32 seq)
+{
+    GameEvent want;
+    make_event(seq, &want);
+    return e->type == want.type && e->id == want.id && e->gen == want.gen &&
+           e->value == want.value && e->x == want.x && e->y == want.y;
+}
+
+static EventRing ring;
+static SDL_AtomicInt writerDone;
+static SDL_AtomicInt readersReady;
+static Uint32 total;
+static Uint64 seed;
+
+typedef struct {
+    const char* name;
+    bool stalls;
+    Uint64 read;
+    Uint64 dropped;
+    Uint64 lappedReads;     // reads that lost events, pre-skip or mid-copy
+    Uint64 stallCount;
+    char error[200];
+} ReaderStats;
+
+static int SDLCALL writer_thread(void* data)
+{
+    (void)data;
+    while (SDL_GetAtomicInt(&readersReady) < 2) SDL_CPUPauseInstruction();
+
+    Rng rng = { seed };
+    for (Uint32 seq = 0; seq < total; ) {
+        // a step's worth, 0..300 events, published at its end
+        Uint32 step = next_u32(&rng) % 301;
+        if (step > total - seq) step = total - seq;
+        for (Uint32 i = 0; i < step; i++, seq++) {
+            GameEvent e;
+            make_event(seq, &e);
+            Events_Push(&ring, &e);
+        }
+        Events_Publish(&ring);
+
+        // idle between some steps so the readers catch up as well as get lapped
+        if (next_u32(&rng) % 4 == 0)
+            for (Uint32 spin = next_u32(&rng) % 2000; spin > 0; spin--) SDL_CPUPauseInstruction();
+    }
+    SDL_SetAtomicInt(&writerDone, 1);
+    return 0;
+}
+
+static int SDLCALL reader_thread(void* data)
+{
+    ReaderStats* st = (ReaderStats*)data;
+    // the stalling one takes all it may in one go, long copies get lapped more
+    static GameEvent bufs[2][EVENT_KEEP];
+    GameEvent* buf = bufs[st->stalls ? 1 : 0];
+    int max = st->stalls ? EVENT_KEEP : EVENT_BATCH;
+    Rng rng = { seed ^ (st->stalls ? 0x9E3779B97F4A7C15ull : 0) };
+
+    EventReader rd;
+    Events_Attach(&ring, &rd);
+    SDL_AddAtomicInt(&readersReady, 1);
+
+    for (;;) {
+        bool done = SDL_GetAtomicInt(&writerDone) != 0;
+        Uint32 from = rd.next;
+        int droppedBefore = rd.dropped;
+
+        int n = Events_Read(&ring, &rd, buf, max);
+
+        // the first one read comes right after everything dropped
+        Uint32 skipped = (Uint32)(rd.dropped - droppedBefore);
+        Uint32 seq = from + skipped;
+        for (int i = 0; i < n; i++, seq++) {
+            if (!whole(&buf[i], seq)) {
+                SDL_snprintf(st->error, sizeof(st->error),
+                             "event %u torn or out of order (id %d, expected %u, %u dropped this read)",
+                             seq, buf[i].id, seq, skipped);
+                return 1;
+            }
+        }
+        if (seq != rd.next) {
+            SDL_snprintf(st->error, sizeof(st->error),
+                         "cursor at %u after reading up to %u", rd.next, seq);
+            return 1;
+        }
+        st->read += (Uint64)n;
+        if (skipped) st->lappedReads++;
+
+        if (n == 0 && done) break;
+
+        // fall behind for a while, long enough for the writer to go round
+        if (st->stalls && next_u32(&rng) % 64 == 0) {
+            st->stallCount++;
+            if (next_u32(&rng) % 4 == 0) SDL_DelayNS(20000);
+            else for (Uint32 spin = next_u32(&rng) % 4000; spin > 0; spin--) SDL_CPUPauseInstruction();
+        }
+    }
+    st->dropped = (Uint64)rd.dropped;
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    total = 20000000;
+    seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!v) break;
+        if      (strcmp(a, "--events") == 0) { total = (Uint32)strtoul(v, NULL, 10); i++; }
+        else if (strcmp(a, "--seed") == 0)   { seed = (Uint64)strtoull(v, NULL, 10); i++; }
+    }
+
+    Events_Init(&ring);
+    SDL_SetAtomicInt(&writerDone, 0);
+    SDL_SetAtomicInt(&readersReady, 0);
+
+    ReaderStats stats[2] = { { .name = "steady" }, { .name = "stalling", .stalls = true } };
+    SDL_Thread* readers[2];
+    for (int i = 0; i < 2; i++)
+        readers[i] = SDL_CreateThread(reader_thread, stats[i].name, &stats[i]);
+    SDL_Thread* writer = SDL_CreateThread(writer_thread, "writer", NULL);
+    if (!writer || !readers[0] || !readers[1]) {
+        fprintf(stderr, "threads failed to start: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    Uint64 t0 = SDL_GetTicksNS();
+    SDL_WaitThread(writer, NULL);
+    bool ok = true;
+    for (int i = 0; i < 2; i++) {
+        int code = 0;
+        SDL_WaitThread(readers[i], &code);
+        const ReaderStats* st = &stats[i];
+        if (code != 0) {
+            printf("%-8s %s\n", st->name, st->error);
+            ok = false;
+            continue;
+        }
+        printf("%-8s read %llu, dropped %llu in %llu reads, %llu stalls\n", st->name,
+               (unsigned long long)st->read, (unsigned long long)st->dropped,
+               (unsigned long long)st->lappedReads, (unsigned long long)st->stallCount);
+        if (st->read + st->dropped != total) {
+            printf("%-8s read + dropped = %llu, pushed %u\n", st->name,
+                   (unsigned long long)(st->read + st->dropped), total);
+            ok = false;
+        }
+    }
+    printf("%u events in %.0f ms\n", total, (double)(SDL_GetTicksNS() - t0) / 1e6);
+
+    printf(ok ? "ok\n" : "EVENTS LOST OR TORN\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// checks every SIMD kernel level against the scalar loops
+//
+// random and edge-case input (zero-length and axis-aligned paths, touching
+// edges, points on the target, odd lengths for the tails) through integrate,
+// chase, sweep and overlap at each level the cpu has. exact mode has to give
+// the scalar bits: positions, alive flags, masks, hit counts and t.
+//
+//   cc -O2 -Imark bench/kernel_check.c mark/kernels.c -lSDL3 -o mark_kernel_check
+//
+//   mark_kernel_check [--trials 3000] [--seed 1]
+//
+// exits with 1 on the first mismatch
+
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernels.h"
+
+#define CHECK_MAX_N 300     // a few vector widths plus every tail length
+#define CHECK_WORDS ((CHECK_MAX_N + 31) / 32)
+
+typedef struct {
+    Uint64 state;
+} Rng;
+
+static Uint32 next_u32(Rng* r)
+{
+    r->state = r->state * 6364136223846793005ull + 1442695040888963407ull;
+    return (Uint32)(r->state >> 33);
+}
+
+static float uniform(Rng* r, float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(next_u32(r) & 0xFFFFFF) / (float)0x1000000;
+}
+
+// mostly random, often one of the values the kernels branch on
+static float pick(Rng* r, float lo, float hi, const float* edges, int edgeCount)
+{
+    if (next_u32(r) % 4 == 0) return edges[next_u32(r) % (Uint32)edgeCount];
+    return uniform(r, lo, hi);
+}
+
+static bool same_bits(const void* a, const void* b, size_t n)
+{
+    return memcmp(a, b, n) == 0;
+}
+
+typedef struct {
+    float x[CHECK_MAX_N], y[CHECK_MAX_N];
+    float px[CHECK_MAX_N], py[CHECK_MAX_N];
+    float x1[CHECK_MAX_N], y1[CHECK_MAX_N];
+    float vx[CHECK_MAX_N], vy[CHECK_MAX_N];
+    float size[CHECK_MAX_N];
+    bool alive[CHECK_MAX_N];
+    Uint32 mask[CHECK_WORDS];
+    float t[CHECK_MAX_N];
+    int hits;
+} Lanes;
+
+static Lanes input, want, got;
+
+// one random case, everything the four kernels read
+typedef struct {
+    int n;
+    float dt;
+    float minX, minY, maxX, maxY;       // integrate bounds
+    float tx, ty;                       // chase target
+    float ox, oy;                       // sweep start offset
+    float bx, by, bw, bh;               // sweep / overlap box
+} Case;
+
+static void make_case(Rng* r, Case* c)
+{
+    c->n = (int)(next_u32(r) % (CHECK_MAX_N + 1));
+    c->dt = (next_u32(r) % 8 == 0) ? 0.0f : uniform(r, 0.001f, 0.1f);
+    c->minX = -60.0f; c->minY = -60.0f;
+    c->maxX = 860.0f; c->maxY = 660.0f;
+    c->tx = uniform(r, 0.0f, 800.0f);
+    c->ty = uniform(r, 0.0f, 600.0f);
+    c->ox = (next_u32(r) % 2) ? 0.0f : uniform(r, -20.0f, 20.0f);
+    c->oy = (next_u32(r) % 2) ? 0.0f : uniform(r, -20.0f, 20.0f);
+    c->bx = (float)(next_u32(r) % 780);
+    c->by = (float)(next_u32(r) % 580);
+    c->bw = (float)(1 + next_u32(r) % 60);
+    c->bh = (next_u32(r) % 2) ? c->bw : (float)(1 + next_u32(r) % 60);
+
+    const float xs[] = { c->bx, c->bx + c->bw, c->tx, c->minX, c->maxX, 0.0f, c->bx + c->bw * 0.5f };
+    const float ys[] = { c->by, c->by + c->bh, c->ty, c->minY, c->maxY, 0.0f, c->by + c->bh * 0.5f };
+    const float vs[] = { 0.0f, 900.0f, -900.0f, 1e-30f };
+
+    for (int i = 0; i < c->n; i++) {
+        input.x[i] = pick(r, -100.0f, 900.0f, xs, (int)SDL_arraysize(xs));
+        input.y[i] = pick(r, -100.0f, 700.0f, ys, (int)SDL_arraysize(ys));
+        input.vx[i] = pick(r, -1000.0f, 1000.0f, vs, (int)SDL_arraysize(vs));
+        input.vy[i] = pick(r, -1000.0f, 1000.0f, vs, (int)SDL_arraysize(vs));
+        input.size[i] = (float)(1 + next_u32(r) % 48);
+        input.alive[i] = next_u32(r) % 8 != 0;
+
+        // path end: a short step, the same point, or straight along an axis
+        switch (next_u32(r) % 4) {
+        case 0:  input.x1[i] = input.x[i]; input.y1[i] = input.y[i]; break;
+        case 1:  input.x1[i] = input.x[i]; input.y1[i] = pick(r, -100.0f, 700.0f, ys, (int)SDL_arraysize(ys)); break;
+        case 2:  input.x1[i] = pick(r, -100.0f, 900.0f, xs, (int)SDL_arraysize(xs)); input.y1[i] = input.y[i]; break;
+        default: input.x1[i] = input.x[i] + uniform(r, -40.0f, 40.0f);
+                 input.y1[i] = input.y[i] + uniform(r, -40.0f, 40.0f); break;
+        }
+    }
+}
+
+// runs all four on a fresh copy of the input, results land in out
+static void run(const Kernels* k, const Case* c, Lanes* out, int which)
+{
+    *out = input;
+    SDL_memset(out->mask, 0xA5, sizeof(out->mask));
+    for (int i = 0; i < CHECK_MAX_N; i++) out->t[i] = 12345.0f;
+
+    switch (which) {
+    case 0:
+        k->integrate(out->x, out->y, out->px, out->py, out->vx, out->vy, out->alive, c->n,
+                     c->dt, c->minX, c->minY, c->maxX, c->maxY);
+        break;
+    case 1:
+        k->chase(out->x, out->y, out->size, c->n, c->tx, c->ty, c->dt);
+        break;
+    case 2:
+        out->hits = k->sweep(out->x, out->y, out->x1, out->y1, c->n, c->ox, c->oy,
+                             c->bx, c->by, c->bw, c->bh, out->mask, out->t);
+        break;
+    default:
+        out->hits = k->overlap(out->x, out->y, out->size, c->n, c->bx, c->by, c->bw, c->bh, out->mask);
+        break;
+    }
+}
+
+static const char* KERNEL_NAMES[4] = { "integrate", "chase", "sweep", "overlap" };
+
+// first lane that differs, -1 = none
+static int first_diff(const Case* c, int which)
+{
+    size_t words = (size_t)((c->n + 31) / 32) * sizeof(Uint32);
+    if ((which >= 2) && (want.hits != got.hits || !same_bits(want.mask, got.mask, words)))
+        return 0;
+
+    for (int i = 0; i < c->n; i++) {
+        bool same = true;
+        if (which <= 1) {
+            same = same_bits(&want.x[i], &got.x[i], sizeof(float)) &&
+                   same_bits(&want.y[i], &got.y[i], sizeof(float));
+        }
+        if (which == 0) {
+            same = same && same_bits(&want.px[i], &got.px[i], sizeof(float)) &&
+                   same_bits(&want.py[i], &got.py[i], sizeof(float)) &&
+                   want.alive[i] == got.alive[i];
+        }
+        if (which == 2) same = same_bits(&want.t[i], &got.t[i], sizeof(float));
+        if (!same) return i;
+    }
+    return -1;
+}
+
+int main(int argc, char* argv[])
+{
+    int trials = 3000;
+    Uint64 seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!v) break;
+        if      (strcmp(a, "--trials") == 0) { trials = atoi(v); i++; }
+        else if (strcmp(a, "--seed") == 0)   { seed = (Uint64)strtoull(v, NULL, 10); i++; }
+    }
+
+    Kernels ref;
+    Kernels_Select(&ref, KERNEL_SCALAR, true);
+
+    int checked = 0;
+    for (int level = KERNEL_SSE41; level <= KERNEL_AVX2; level++) {
+        Kernels k;
+        Kernels_Select(&k, (KernelLevel)level, true);
+        if ((int)k.level != level) {
+            printf("%-7s not on this cpu, skipped\n", Kernels_Name((KernelLevel)level));
+            continue;
+        }
+
+        // same cases at every level
+        Rng rng = { seed };
+        for (int trial = 0; trial < trials; trial++) {
+            Case c;
+            make_case(&rng, &c);
+
+            for (int which = 0; which < 4; which++) {
+                run(&ref, &c, &want, which);
+                run(&k, &c, &got, which);
+
+                int lane = first_diff(&c, which);
+                if (lane < 0) continue;
+
+                printf("%s %s differs from scalar: trial %d, n %d, lane %d\n",
+                       Kernels_Name(k.level), KERNEL_NAMES[which], trial, c.n, lane);
+                printf("  in  x %.9g y %.9g x1 %.9g y1 %.9g size %.9g\n",
+                       input.x[lane], input.y[lane], input.x1[lane], input.y1[lane], input.size[lane]);
+                printf("  out x %.9g/%.9g y %.9g/%.9g t %.9g/%.9g hits %d/%d\n",
+                       want.x[lane], got.x[lane], want.y[lane], got.y[lane],
+                       want.t[lane], got.t[lane], want.hits, got.hits);
+                return 1;
+            }
+        }
+        printf("%-7s matches scalar, %d trials x 4 kernels\n", Kernels_Name(k.level), trials);
+        checked++;
+    }
+
+    if (checked == 0) printf("only scalar kernels here, nothing to compare\n");
+    return 0;
+}
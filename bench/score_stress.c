@@ -0,0 +1,126 @@
+// score file stress test, many game processes saving at once
+//
+// starts --writers copies of itself, each submits --runs runs under its own
+// name through ScoreSync (lock -> reread -> merge -> write -> rename) while
+// the others do the same. afterwards every writer's best score and every run
+// has to be in the file, a lost update shows up as a missing name, a stale
+// best or a short run count.
+//
+//   cc -O2 -Imark bench/score_stress.c mark/scores.c -lSDL3 -o mark_score_stress
+//
+//   mark_score_stress [--writers 32] [--runs 20] [--path score_stress.txt]
+//
+// exits with 1 when something was lost
+
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scores.h"
+
+#define STRESS_MAX_WRITERS SCORE_MAX    // one board entry each
+
+static int best_kills(int writer, int runs)
+{
+    return (runs - 1) * 100 + writer;
+}
+
+// child: submit the runs as fast as the worker takes them
+static int writer(const char* path, int w, int runs)
+{
+    char name[NAME_MAX];
+    SDL_snprintf(name, (int)sizeof(name), "w%02d", w);
+
+    ScoreSync s;
+    ScoreSync_Start(&s, path);
+    for (int r = 0; r < runs; r++) {
+        ScoreSync_Submit(&s, name, r * 100 + w, Scores_Today());
+        SDL_Delay(1);
+    }
+    ScoreSync_Stop(&s);
+    return 0;
+}
+
+static void remove_files(const char* path)
+{
+    // side files too, an older build's would be read as this table's history
+    const char* ext[] = { "", ".tmp", ".lock", ".hist", ".days" };
+    for (int i = 0; i < 5; i++) {
+        char p[300];
+        SDL_snprintf(p, (int)sizeof(p), "%s%s", path, ext[i]);
+        SDL_RemovePath(p);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int writers = 32;
+    int runs = 20;
+    const char* path = "score_stress.txt";
+    int child = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!v) break;
+        if      (strcmp(a, "--writers") == 0) { writers = atoi(v); i++; }
+        else if (strcmp(a, "--runs") == 0)    { runs = atoi(v); i++; }
+        else if (strcmp(a, "--path") == 0)    { path = v; i++; }
+        else if (strcmp(a, "--child") == 0)   { child = atoi(v); i++; }
+    }
+    if (writers < 1) writers = 1;
+    if (writers > STRESS_MAX_WRITERS) writers = STRESS_MAX_WRITERS;
+    if (runs < 1) runs = 1;
+
+    if (child >= 0) return writer(path, child, runs);
+
+    remove_files(path);
+
+    // all of them up before any gets far, so the saves overlap
+    SDL_Process* procs[STRESS_MAX_WRITERS] = { 0 };
+    char wArg[16], rArg[16];
+    SDL_snprintf(rArg, (int)sizeof(rArg), "%d", runs);
+    for (int w = 0; w < writers; w++) {
+        SDL_snprintf(wArg, (int)sizeof(wArg), "%d", w);
+        const char* args[] = { argv[0], "--child", wArg, "--runs", rArg, "--path", path, NULL };
+        procs[w] = SDL_CreateProcess(args, false);
+        if (!procs[w]) {
+            fprintf(stderr, "writer %d failed to start: %s\n", w, SDL_GetError());
+            return 1;
+        }
+    }
+
+    int failed = 0;
+    for (int w = 0; w < writers; w++) {
+        int code = 0;
+        if (!SDL_WaitProcess(procs[w], true, &code) || code != 0) failed++;
+        SDL_DestroyProcess(procs[w]);
+    }
+
+    static ScoreState st;
+    Scores_Load(path, &st, Scores_Today());
+    const ScoreBoard* all = &st.boards[BOARD_ALL];
+
+    int lost = 0;
+    for (int w = 0; w < writers; w++) {
+        char name[NAME_MAX];
+        SDL_snprintf(name, (int)sizeof(name), "w%02d", w);
+        int i = Scores_Find(all->top, all->count, name);
+        int want = best_kills(w, runs);
+        if (i < 0) {
+            printf("  %s missing\n", name);
+            lost++;
+        } else if (all->top[i].bestKills != want) {
+            printf("  %s best %d, expected %d\n", name, all->top[i].bestKills, want);
+            lost++;
+        }
+    }
+
+    int runsWant = writers * runs;
+    printf("%d writers x %d runs: %d/%d bests, %d/%d runs recorded, %d writers failed\n",
+        writers, runs, writers - lost, writers, all->hist.total, runsWant, failed);
+
+    bool ok = lost == 0 && failed == 0 && all->hist.total == runsWant;
+    printf(ok ? "ok\n" : "LOST UPDATES\n");
+    return ok ? 0 : 1;
+}
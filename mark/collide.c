@@ -0,0 +1,185 @@
+#include "collide.h"
+#include "game.h"
+#include <stdlib.h>
+
+static void push(ContactList* l, int type, int a, int b, float t)
+{
+    if (l->count == l->cap) {
+        int cap = l->cap ? l->cap * 2 : 256;
+        Contact* items = (Contact*)SDL_realloc(l->items, sizeof(Contact) * (size_t)cap);
+        if (!items) return;
+        l->items = items;
+        l->cap = cap;
+    }
+
+    Contact* c = &l->items[l->count++];
+    c->type = type;
+    c->a = a;
+    c->b = b;
+    c->t = t;
+}
+
+// mask/t scratch is on the stack, paths go through the kernels this many at a time
+#define COLLIDE_BLOCK 256
+
+static bool grow(float** arr, int cap)
+{
+    float* p = (float*)SDL_realloc(*arr, sizeof(float) * (size_t)cap);
+    if (!p) return false;
+    *arr = p;
+    return true;
+}
+
+bool Contacts_ReserveBatch(CollideBatch* cb, int paths, int boxes)
+{
+    if (cb->pathCap < paths) {
+        int* slot = (int*)SDL_realloc(cb->slot, sizeof(int) * (size_t)paths);
+        if (slot) cb->slot = slot;
+        if (!slot || !grow(&cb->x0, paths) || !grow(&cb->y0, paths) || !grow(&cb->x1, paths) || !grow(&cb->y1, paths))
+            return false;
+        cb->pathCap = paths;
+    }
+    if (cb->boxCap < boxes) {
+        if (!grow(&cb->ex, boxes) || !grow(&cb->ey, boxes) || !grow(&cb->esize, boxes))
+            return false;
+        cb->boxCap = boxes;
+    }
+    return true;
+}
+
+void Contacts_Pack(Game* g)
+{
+    CollideBatch* cb = &g->batch;
+
+    int n = 0;
+    for (int i = 0; i < g->maxBullets; i++) {
+        const Bullet* b = &g->bullets[i];
+        if (!b->alive) continue;
+        cb->x0[n] = b->px;
+        cb->y0[n] = b->py;
+        cb->x1[n] = b->x;
+        cb->y1[n] = b->y;
+        cb->slot[n] = i;
+        n++;
+    }
+    cb->paths = n;
+
+    for (int i = 0; i < g->maxEnemies; i++) {
+        const Enemy* en = &g->enemies[i];
+        cb->ex[i] = en->x;
+        cb->ey[i] = en->y;
+        cb->esize[i] = en->size;
+    }
+    cb->boxes = g->maxEnemies;
+}
+
+void Contacts_FreeBatch(CollideBatch* b)
+{
+    SDL_free(b->x0);
+    SDL_free(b->y0);
+    SDL_free(b->x1);
+    SDL_free(b->y1);
+    SDL_free(b->slot);
+    SDL_free(b->ex);
+    SDL_free(b->ey);
+    SDL_free(b->esize);
+    SDL_zerop(b);
+}
+
+void Contacts_DetectEBullets(const Game* g, int begin, int end, ContactList* out)
+{
+    const Player* p = &g->p;
+
+    // paths are taken in the player's frame, a dash can't skip through a bullet either
+    float mx = p->x - p->px;
+    float my = p->y - p->py;
+
+    const EBulletPool* eb = &g->eb;
+    Uint32 mask[COLLIDE_BLOCK / 32];
+    float t[COLLIDE_BLOCK];
+
+    for (int i = begin; i < end; i += COLLIDE_BLOCK) {
+        int n = SDL_min(COLLIDE_BLOCK, end - i);
+        if (!g->kern.sweep(eb->px + i, eb->py + i, eb->x + i, eb->y + i, n, mx, my,
+                           p->x, p->y, p->size, p->size, mask, t))
+            continue;
+
+        for (int k = 0; k < n; k++) {
+            if (!(mask[k >> 5] & (1u << (k & 31))) || !eb->alive[i + k]) continue;
+            push(out, CONTACT_EBULLET_PLAYER, i + k, -1, t[k]);
+        }
+    }
+}
+
+void Contacts_DetectEnemies(const Game* g, int begin, int end, ContactList* out)
+{
+    const Player* p = &g->p;
+    const CollideBatch* cb = &g->batch;
+    Uint32 mask[COLLIDE_BLOCK / 32];
+    float t[COLLIDE_BLOCK];
+
+    for (int i = begin; i < end; i += COLLIDE_BLOCK) {
+        int n = SDL_min(COLLIDE_BLOCK, end - i);
+        if (!g->kern.overlap(cb->ex + i, cb->ey + i, cb->esize + i, n, p->x, p->y, p->size, p->size, mask))
+            continue;
+
+        for (int k = 0; k < n; k++) {
+            if (!(mask[k >> 5] & (1u << (k & 31))) || !g->enemies[i + k].alive) continue;
+            push(out, CONTACT_ENEMY_PLAYER, i + k, -1, 0.0f);
+        }
+    }
+
+    for (int i = begin; i < end; i++) {
+        const Enemy* en = &g->enemies[i];
+        if (!en->alive) continue;
+
+        // every bullet whose path crosses the enemy (in the enemy's frame),
+        // resolve walks them by t and decides which ones land
+        float mx = en->x - en->px;
+        float my = en->y - en->py;
+
+        for (int j = 0; j < cb->paths; j += COLLIDE_BLOCK) {
+            int n = SDL_min(COLLIDE_BLOCK, cb->paths - j);
+            if (!g->kern.sweep(cb->x0 + j, cb->y0 + j, cb->x1 + j, cb->y1 + j, n, mx, my,
+                               en->x, en->y, en->size, en->size, mask, t))
+                continue;
+
+            for (int k = 0; k < n; k++) {
+                if (mask[k >> 5] & (1u << (k & 31)))
+                    push(out, CONTACT_BULLET_ENEMY, i, cb->slot[j + k], t[k]);
+            }
+        }
+    }
+}
+
+void Contacts_Append(ContactList* dst, const ContactList* src)
+{
+    for (int i = 0; i < src->count; i++)
+        push(dst, src->items[i].type, src->items[i].a, src->items[i].b, src->items[i].t);
+}
+
+// ebullet hits first (by ebullet), then enemy touches (by enemy), then
+// bullet hits in the order they happen along the tick
+static int cmp_contact(const void* pa, const void* pb)
+{
+    const Contact* a = (const Contact*)pa;
+    const Contact* b = (const Contact*)pb;
+
+    if (a->type != b->type) return a->type - b->type;
+    if (a->type == CONTACT_BULLET_ENEMY && a->t != b->t) return (a->t < b->t) ? -1 : 1;
+    if (a->a != b->a) return (a->a < b->a) ? -1 : 1;
+    if (a->b != b->b) return (a->b < b->b) ? -1 : 1;
+    return 0;
+}
+
+void Contacts_Sort(ContactList* l)
+{
+    if (l->count > 1) qsort(l->items, (size_t)l->count, sizeof(Contact), cmp_contact);
+}
+
+void Contacts_Free(ContactList* l)
+{
+    SDL_free(l->items);
+    l->items = NULL;
+    l->count = l->cap = 0;
+}
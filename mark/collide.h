@@ -0,0 +1,60 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+struct Game;
+
+typedef enum {
+    CONTACT_EBULLET_PLAYER = 0,
+    CONTACT_ENEMY_PLAYER = 1,
+    CONTACT_BULLET_ENEMY = 2,
+} ContactType;
+
+// a = ebullet index (ebullet->player) or enemy index, b = bullet index
+// t = where along the bullet's path this tick it hits, 0..1
+typedef struct {
+    int type;
+    int a, b;
+    float t;
+} Contact;
+
+typedef struct {
+    Contact* items;
+    int count;
+    int cap;
+} ContactList;
+
+// flat copies the batch kernels run over, refilled by Contacts_Pack each tick
+typedef struct {
+    // live bullet paths in slot order, slot = where each came from
+    float* x0;
+    float* y0;
+    float* x1;
+    float* y1;
+    int* slot;
+    int paths;
+
+    // enemy boxes by slot, dead ones included (callers check alive)
+    float* ex;
+    float* ey;
+    float* esize;
+    int boxes;
+
+    int pathCap, boxCap;
+} CollideBatch;
+
+// room for every bullet/enemy slot, Game_Reserve keeps it in step with the pools
+bool Contacts_ReserveBatch(CollideBatch* b, int paths, int boxes);
+void Contacts_FreeBatch(CollideBatch* b);
+
+// copies bullet paths and enemy boxes out once, before the detect pass
+void Contacts_Pack(struct Game* g);
+
+// detection only reads the game, so ranges can run on separate chunks
+// each chunk fills its own list, Contacts_Append joins them
+void Contacts_DetectEBullets(const struct Game* g, int begin, int end, ContactList* out);
+void Contacts_DetectEnemies(const struct Game* g, int begin, int end, ContactList* out);
+
+void Contacts_Append(ContactList* dst, const ContactList* src);
+void Contacts_Sort(ContactList* l);
+void Contacts_Free(ContactList* l);
@@ -0,0 +1,54 @@
+#include "events.h"
+
+void Events_Init(EventRing* r)
+{
+    SDL_SetAtomicInt(&r->head, 0);
+    r->pushed = 0;
+}
+
+void Events_Push(EventRing* r, const GameEvent* e)
+{
+    r->items[r->pushed & (EVENT_RING - 1)] = *e;
+    if ((++r->pushed & (EVENT_PUBLISH - 1)) == 0) Events_Publish(r);
+}
+
+void Events_Publish(EventRing* r)
+{
+    // slots are written before the new head is visible
+    SDL_SetAtomicInt(&r->head, (int)r->pushed);
+}
+
+void Events_Attach(const EventRing* r, EventReader* rd)
+{
+    rd->next = (Uint32)SDL_GetAtomicInt((SDL_AtomicInt*)&r->head);
+    rd->dropped = 0;
+}
+
+int Events_Read(const EventRing* r, EventReader* rd, GameEvent* out, int max)
+{
+    Uint32 head = (Uint32)SDL_GetAtomicInt((SDL_AtomicInt*)&r->head);
+
+    // already overwritten, skip to the oldest still there
+    if (head - rd->next > EVENT_KEEP) {
+        rd->dropped += (int)(head - rd->next - EVENT_KEEP);
+        rd->next = head - EVENT_KEEP;
+    }
+
+    Uint32 n = head - rd->next;
+    if (n > (Uint32)max) n = (Uint32)max;
+    for (Uint32 i = 0; i < n; i++)
+        out[i] = r->items[(rd->next + i) & (EVENT_RING - 1)];
+
+    // from another thread the writer may have lapped the front of the copy meanwhile
+    Uint32 after = (Uint32)SDL_GetAtomicInt((SDL_AtomicInt*)&r->head);
+    Uint32 lost = 0;
+    if (after - rd->next > EVENT_KEEP) lost = after - rd->next - EVENT_KEEP;
+    if (lost > n) lost = n;
+    if (lost) {
+        SDL_memmove(out, out + lost, sizeof(GameEvent) * (size_t)(n - lost));
+        rd->dropped += (int)lost;
+    }
+
+    rd->next += n;
+    return (int)(n - lost);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+#define EVENT_RING    2048  // power of two
+#define EVENT_PUBLISH 64    // the writer makes its events visible at least this often
+#define EVENT_KEEP    (EVENT_RING - EVENT_PUBLISH)  // most a reader can trail by, the writer may be that far past head
+#define EVENT_BATCH   256   // events a reader takes per Events_Read, typically
+
+// what happened in the sim, pushed where it happens and handled after
+// the step by whoever cares (damage numbers, scoring, later audio/telemetry)
+typedef enum {
+    EVENT_ENEMY_HIT = 0,    // id/gen = enemy slot and generation, value = damage, x/y = where the number shows
+    EVENT_ENEMY_KILLED,     // id/gen = enemy slot and generation, value = its EnemyType
+    EVENT_PLAYER_HIT,       // value = damage, x/y = where the number shows
+    EVENT_PLAYER_DIED,
+    EVENT_SHOT_FIRED,       // player's bullet, id = bullet slot, x/y = muzzle
+} EventType;
+
+typedef struct {
+    EventType type;
+    int id;
+    Uint32 gen;     // owner's generation, slots get reused
+    int value;
+    float x, y;
+} GameEvent;
+
+// lock-free ring, one writer (the sim) and any number of readers, each with
+// its own cursor. the writer never waits: a reader that falls more than
+// EVENT_KEEP behind loses the oldest events and gets told how many.
+// pushes are plain stores, readers see them once they're published
+typedef struct {
+    GameEvent items[EVENT_RING];
+    SDL_AtomicInt head;     // events published, only the writer stores it
+    Uint32 pushed;          // events pushed, writer only
+} EventRing;
+
+typedef struct {
+    Uint32 next;            // next event to read
+    int dropped;            // lapped by the writer before it got to them
+} EventReader;
+
+void Events_Init(EventRing* r);
+void Events_Push(EventRing* r, const GameEvent* e);
+// makes everything pushed so far visible to readers (end of a step)
+void Events_Publish(EventRing* r);
+// from now on, nothing already pushed
+void Events_Attach(const EventRing* r, EventReader* rd);
+// copies up to max of the reader's events oldest first, returns how many
+int  Events_Read(const EventRing* r, EventReader* rd, GameEvent* out, int max);
+
+// pushed but not read yet, writer side: the check before it laps a reader
+static inline Uint32 Events_Unread(const EventRing* r, const EventReader* rd)
+{
+    return r->pushed - rd->next;
+}
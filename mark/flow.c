@@ -0,0 +1,227 @@
+#include "flow.h"
+
+#define FLOW_INF  0xFFFFFFFFu
+#define FLOW_DONE (-2)
+
+// 4 straight steps first, then the diagonals
+static const int STEP_DC[8] = { 1, -1, 0,  0, 1,  1, -1, -1 };
+static const int STEP_DR[8] = { 0,  0, 1, -1, 1, -1,  1, -1 };
+
+static bool reserve(FlowField* f, int cells)
+{
+    if (f->cap >= cells) return true;
+
+    Uint32* dist = (Uint32*)SDL_realloc(f->dist, sizeof(Uint32) * (size_t)cells);
+    if (dist) f->dist = dist;
+    float* dx = (float*)SDL_realloc(f->dx, sizeof(float) * (size_t)cells);
+    if (dx) f->dx = dx;
+    float* dy = (float*)SDL_realloc(f->dy, sizeof(float) * (size_t)cells);
+    if (dy) f->dy = dy;
+    int* next = (int*)SDL_realloc(f->next, sizeof(int) * (size_t)cells);
+    if (next) f->next = next;
+    int* prev = (int*)SDL_realloc(f->prev, sizeof(int) * (size_t)cells);
+    if (prev) f->prev = prev;
+    Uint8* steps = (Uint8*)SDL_realloc(f->steps, (size_t)cells);
+    if (steps) f->steps = steps;
+    if (!dist || !dx || !dy || !next || !prev || !steps) return false;
+
+    f->cap = cells;
+    return true;
+}
+
+static bool open_cell(const FlowField* f, int c, int r)
+{
+    if (c < 0 || r < 0 || c >= f->cols || r >= f->rows) return false;
+    return !f->blocked || !f->blocked[r * f->cols + c];
+}
+
+// bit k = step k is allowed from (c, r).
+// diagonals need both straight cells open, no cutting wall corners
+static Uint8 step_mask(const FlowField* f, int c, int r)
+{
+    unsigned m = 0;
+    for (int k = 0; k < 4; k++)
+        if (open_cell(f, c + STEP_DC[k], r + STEP_DR[k])) m |= 1u << k;
+    // straight bits: 0 = +x, 1 = -x, 2 = +y, 3 = -y
+    static const unsigned NEED[4] = { 1u | 4u, 1u | 8u, 2u | 4u, 2u | 8u };
+    for (int k = 4; k < 8; k++)
+        if ((m & NEED[k - 4]) == NEED[k - 4] && open_cell(f, c + STEP_DC[k], r + STEP_DR[k]))
+            m |= 1u << k;
+    return (Uint8)m;
+}
+
+/* ------------------ bucket queue ------------------ */
+
+// steps cost 10 or 14, so every queued cost sits within 14 of the one
+// being settled and one lap of 16 buckets keeps them apart (dial's queue)
+#define FLOW_RING 16
+
+static void queue_add(FlowField* f, int* head, int v)
+{
+    int b = (int)(f->dist[v] & (FLOW_RING - 1));
+    f->next[v] = head[b];
+    f->prev[v] = -1;
+    if (head[b] >= 0) f->prev[head[b]] = v;
+    head[b] = v;
+}
+
+static void queue_remove(FlowField* f, int* head, int v)
+{
+    if (f->prev[v] >= 0) f->next[f->prev[v]] = f->next[v];
+    else head[f->dist[v] & (FLOW_RING - 1)] = f->next[v];
+    if (f->next[v] >= 0) f->prev[f->next[v]] = f->prev[v];
+}
+
+/* ------------------ build ------------------ */
+
+static void build(FlowField* f, int goal, Uint32 limit)
+{
+    int cols = f->cols;
+    int cells = cols * f->rows;
+    for (int i = 0; i < cells; i++) {
+        f->dist[i] = FLOW_INF;
+        f->next[i] = -1;
+    }
+
+    // dijkstra out from the goal, one pass over every reachable cell.
+    // queued = has a cost and isn't done yet
+    int head[FLOW_RING];
+    for (int b = 0; b < FLOW_RING; b++) head[b] = -1;
+    f->dist[goal] = 0;
+    queue_add(f, head, goal);
+    int queued = 1;
+
+    for (Uint32 cur = 0; queued > 0; ) {
+        int b = (int)(cur & (FLOW_RING - 1));
+        int u = head[b];
+        if (u < 0) { cur++; continue; }
+        if (limit && cur > limit) break;
+
+        queue_remove(f, head, u);
+        f->next[u] = FLOW_DONE;
+        queued--;
+
+        unsigned m = f->steps[u];
+        for (int k = 0; k < 8; k++) {
+            if (!(m & (1u << k))) continue;
+            int v = u + STEP_DR[k] * cols + STEP_DC[k];
+            if (f->next[v] == FLOW_DONE) continue;
+
+            Uint32 d = cur + (k < 4 ? 10u : 14u);
+            if (d >= f->dist[v]) continue;
+            if (f->dist[v] != FLOW_INF) queue_remove(f, head, v);
+            else queued++;
+            f->dist[v] = d;
+            queue_add(f, head, v);
+        }
+    }
+
+    // past the reach nothing is final, those cells chase straight
+    if (limit) {
+        for (int i = 0; i < cells; i++)
+            if (f->next[i] != FLOW_DONE) f->dist[i] = FLOW_INF;
+    }
+
+    // directions. a cell whose cost is the plain octile distance has no
+    // detour to make, it keeps 0/0 and chases the exact target position.
+    // the rest blend every downhill step by how much it gains, and take
+    // the single steepest one where that blend cancels out (saddles behind a wall)
+    int gc = goal % cols, gr = goal / cols;
+    for (int ur = 0, u = 0; ur < f->rows; ur++)
+        for (int uc = 0; uc < cols; uc++, u++) {
+            f->dx[u] = f->dy[u] = 0.0f;
+            if (f->dist[u] == FLOW_INF || u == goal) continue;
+
+            int ac = SDL_abs(uc - gc), ar = SDL_abs(ur - gr);
+            Uint32 straight = 10u * (Uint32)SDL_max(ac, ar) + 4u * (Uint32)SDL_min(ac, ar);
+            if (f->dist[u] == straight) continue;
+
+            unsigned m = f->steps[u];
+            float sx = 0.0f, sy = 0.0f;
+            float bx = 0.0f, by = 0.0f, best = 0.0f;
+            for (int k = 0; k < 8; k++) {
+                if (!(m & (1u << k))) continue;
+                int v = u + STEP_DR[k] * cols + STEP_DC[k];
+                if (f->dist[v] >= f->dist[u]) continue;
+
+                // gain per unit of length, along the unit step
+                float inv = k < 4 ? 1.0f : 0.70710678f;
+                float w = (float)(f->dist[u] - f->dist[v]) * (k < 4 ? 0.1f : 1.0f / 14.0f);
+                sx += (float)STEP_DC[k] * inv * w;
+                sy += (float)STEP_DR[k] * inv * w;
+                if (w > best) {
+                    best = w;
+                    bx = (float)STEP_DC[k] * inv;
+                    by = (float)STEP_DR[k] * inv;
+                }
+            }
+
+            float len = SDL_sqrtf(sx * sx + sy * sy);
+            if (len > 0.0f && sx * bx + sy * by > 0.5f * len) {
+                f->dx[u] = sx / len;
+                f->dy[u] = sy / len;
+            }
+            else {
+                f->dx[u] = bx;
+                f->dy[u] = by;
+            }
+        }
+}
+
+bool Flow_Update(FlowField* f, float cell, float x0, float y0, float w, float h,
+                 const Uint8* blocked, float reach, float tx, float ty)
+{
+    int cols = (int)(w / cell) + 1;
+    int rows = (int)(h / cell) + 1;
+    if (f->stale || cols != f->cols || rows != f->rows || cell != f->cell || blocked != f->blocked ||
+        reach != f->reach || x0 != f->ox || y0 != f->oy) {
+        if (!reserve(f, cols * rows)) return false;
+        f->cell = cell;
+        f->ox = x0;
+        f->oy = y0;
+        f->cols = cols;
+        f->rows = rows;
+        f->blocked = blocked;
+        f->reach = reach;
+        f->stale = false;
+        f->goal = -1;
+
+        // open arena: nothing to walk around, every cell chases straight
+        if (!blocked) {
+            SDL_memset(f->dx, 0, sizeof(float) * (size_t)(cols * rows));
+            SDL_memset(f->dy, 0, sizeof(float) * (size_t)(cols * rows));
+        }
+        else {
+            for (int r = 0, u = 0; r < rows; r++)
+                for (int c = 0; c < cols; c++, u++) f->steps[u] = step_mask(f, c, r);
+        }
+    }
+
+    int goal = Flow_Cell(f, tx, ty);
+    if (goal == f->goal) return true;
+    if (!blocked) {
+        f->goal = goal;
+        return true;
+    }
+
+    build(f, goal, reach > 0.0f ? (Uint32)(reach / cell * 10.0f) : 0u);
+    f->goal = goal;
+    f->builds++;
+    return true;
+}
+
+void Flow_Reset(FlowField* f)
+{
+    f->stale = true;
+}
+
+void Flow_Free(FlowField* f)
+{
+    SDL_free(f->steps);
+    SDL_free(f->dist);
+    SDL_free(f->dx);
+    SDL_free(f->dy);
+    SDL_free(f->next);
+    SDL_free(f->prev);
+    SDL_zerop(f);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+// flow field toward one target (the player) over a coarse grid.
+// rebuilt only when the target steps into another cell, every chaser
+// then reads the direction of its own cell, whatever the enemy count.
+// a rebuild is a full dijkstra from scratch, only bounded by reach: when the
+// goal moves every cost is relative to the new cell, so patching the old
+// dist[] would touch the same cells. it's tens of ns per cell within reach
+// and happens at most a few times a second (bench flow_build)
+typedef struct {
+    float cell;
+    float ox, oy;           // world position of cell 0's corner
+    int cols, rows;
+    const Uint8* blocked;   // cols * rows, nonzero = wall, NULL = open arena
+    float reach;            // path length the search stops at, 0 = whole map
+    int goal;               // cell the field points at, -1 = rebuild next update
+
+    // cost to the goal, 10 per straight step and 14 per diagonal
+    // (only filled when there are walls)
+    Uint32* dist;
+    // downhill direction per cell. 0/0 = nothing in the way, go straight
+    // at the target (also the goal cell and cells that can't reach it)
+    float* dx;
+    float* dy;
+
+    Uint8* steps;           // per cell, bit k = step k is open (read from blocked once)
+
+    // bucket queue links while building
+    int* next;
+    int* prev;
+    int cap;
+    bool stale;             // walls changed in place, re-read them
+
+    int builds;             // how often it was recomputed
+} FlowField;
+
+// points the field at (tx, ty). same cell, area and walls as last time = no work
+// (x0, y0, w, h) = area covered, the whole world unless it's streamed
+// blocked = optional cols * rows array for this cell size, ((int)(w / cell) + 1) columns
+// reach = optional path length around the target worth searching, cells
+// further than that chase straight (large worlds, they're off screen)
+bool Flow_Update(FlowField* f, float cell, float x0, float y0, float w, float h,
+                 const Uint8* blocked, float reach, float tx, float ty);
+// walls edited in place or a new map in the same buffer, next update re-reads them and rebuilds
+void Flow_Reset(FlowField* f);
+void Flow_Free(FlowField* f);
+
+static inline int Flow_Cell(const FlowField* f, float x, float y)
+{
+    int c = SDL_clamp((int)((x - f->ox) / f->cell), 0, f->cols - 1);
+    int r = SDL_clamp((int)((y - f->oy) / f->cell), 0, f->rows - 1);
+    return r * f->cols + c;
+}
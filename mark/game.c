@@ -5,148 +5,148 @@
 #include <stdio.h>
 
 static const char* SCORE_FILE = "mark_scores.txt";
+static const char* ARENA_FILE = "mark_arena.txt";
+
+#define DMG_NUM_MS       750    // on screen after the last hit
+#define DMG_NUM_MERGE_MS 250    // a hit this soon after the last one adds to its number
+#define DMG_NUM_RISE     45.0f  // px/s it floats up
 
 /* ------------------ score helpers ------------------ */
 
-static void trim_newline(char* s)
+static void submit_score(Game* g, const char* name, int kills)
 {
-    size_t n = strlen(s);
-    while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r')) {
-        s[n - 1] = 0;
-        n--;
-    }
+    if (!name || name[0] == 0) return;
+
+    // local boards right away, disk merge happens on the writer thread
+    int day = Scores_Today();
+    Scores_Add(&g->score, name, kills, day);
+    ScoreSync_Submit(&g->scoreSync, name, kills, day);
 }
 
-static int find_score_index(Game* g, const char* name)
+static int best_for_name(const ScoreBoard* b, const char* name)
 {
-    for (int i = 0; i < g->scoreCount; i++) {
-        if (strcmp(g->scores[i].name, name) == 0) return i;
-    }
-    return -1;
+    int idx = Scores_Find(b->top, b->count, name);
+    return (idx >= 0) ? b->top[idx].bestKills : 0;
 }
 
-static void sort_scores(Game* g)
+/* ------------------ timers ------------------ */
+
+// what a wheel timer is for. id = enemy slot, gen = its
+// generation then. nothing gets cancelled, a stale one is ignored when it fires
+typedef enum {
+    TIMER_IFRAMES = 0,
+    TIMER_RELOAD,
+    TIMER_DASH_END,
+    TIMER_DASH_READY,
+    TIMER_SHOOT,        // archer cooldown ran out
+    TIMER_WINDUP,       // archer shot leaves
+    TIMER_STRAFE,       // archer turns around
+    TIMER_EMIT,         // stress emitter burst
+} TimerKind;
+
+// game clock on the wheel, to the nearest ms so whole ticks add up exactly
+static Uint64 clock_ms(double t)
 {
-    for (int i = 0; i < g->scoreCount; i++) {
-        for (int j = 0; j < g->scoreCount - 1; j++) {
-            if (g->scores[j].bestKills < g->scores[j + 1].bestKills) {
-                ScoreEntry tmp = g->scores[j];
-                g->scores[j] = g->scores[j + 1];
-                g->scores[j + 1] = tmp;
-            }
-        }
-    }
+    return (Uint64)(t * 1000.0 + 0.5);
 }
 
-static void load_scores(Game* g)
+// goes off at the first tick that ends secs or more from now on the game clock
+static void schedule(Game* g, TimerKind kind, Uint32 id, Uint32 gen, float secs)
 {
-    g->scoreCount = 0;
-
-    FILE* f = fopen(SCORE_FILE, "r");
-    if (!f) return;
-
-    char line[128];
-    while (fgets(line, (int)sizeof(line), f)) {
-        trim_newline(line);
-        if (line[0] == 0) continue;
-
-        // format: name,kills
-        char* comma = strchr(line, ',');
-        if (!comma) continue;
-        *comma = 0;
+    Timers_Add(&g->timers, clock_ms(g->clock + (double)secs), kind, id, gen);
+}
 
-        const char* name = line;
-        const char* killsStr = comma + 1;
+/* ------------------ gameplay helpers ------------------ */
 
-        if (name[0] == 0) continue;
-        int k = atoi(killsStr);
-        if (k < 0) k = 0;
+// a target hit again within DMG_NUM_MERGE_MS keeps one number that adds up,
+// it moves to the newest end so the pool stays in last-hit order.
+// a full pool drops its oldest, big fights cost at most MAX_DMG_NUMS numbers
+static void spawn_dmg(Game* g, Uint32 target, Uint32 gen, float x, float y, int value)
+{
+    Uint32 now = (Uint32)clock_ms(g->clock);
+    DamageNum* d = g->dmgnums;
+    int n = g->dmgCount;
+
+    // newest first, only the ones still inside the window
+    for (int i = n - 1; i >= 0 && now - d[i].born < DMG_NUM_MERGE_MS; i--) {
+        if (d[i].target != target || d[i].targetGen != gen) continue;
+        value += d[i].value;
+        SDL_memmove(&d[i], &d[i + 1], sizeof(DamageNum) * (size_t)(n - 1 - i));
+        n--;
+        break;
+    }
 
-        // add/update
-        int idx = find_score_index(g, name);
-        if (idx >= 0) {
-            if (k > g->scores[idx].bestKills) g->scores[idx].bestKills = k;
-        }
-        else {
-            if (g->scoreCount < SCORE_MAX) {
-                SDL_strlcpy(g->scores[g->scoreCount].name, name, NAME_MAX);
-                g->scores[g->scoreCount].bestKills = k;
-                g->scoreCount++;
-            }
-        }
+    if (n == MAX_DMG_NUMS) {
+        SDL_memmove(&d[0], &d[1], sizeof(DamageNum) * (size_t)(n - 1));
+        n--;
     }
 
-    fclose(f);
-    sort_scores(g);
+    d[n] = (DamageNum){ x, y, value, now, target, gen };
+    g->dmgCount = n + 1;
 }
 
-static void save_scores(Game* g)
+// oldest first, so the ones past their time are a prefix
+static void expire_dmg_nums(Game* g)
 {
-    FILE* f = fopen(SCORE_FILE, "w");
-    if (!f) return;
+    Uint32 now = (Uint32)clock_ms(g->clock);
+    int k = 0;
+    while (k < g->dmgCount && now - g->dmgnums[k].born >= DMG_NUM_MS) k++;
+    if (k == 0) return;
 
-    for (int i = 0; i < g->scoreCount; i++) {
-        fprintf(f, "%s,%d\n", g->scores[i].name, g->scores[i].bestKills);
-    }
-    fclose(f);
+    g->dmgCount -= k;
+    SDL_memmove(&g->dmgnums[0], &g->dmgnums[k], sizeof(DamageNum) * (size_t)g->dmgCount);
 }
 
-static void submit_score(Game* g, const char* name, int kills)
+static bool player_can_take_damage(Game* g)
 {
-    if (!name || name[0] == 0) return;
-
-    int idx = find_score_index(g, name);
-    if (idx >= 0) {
-        if (kills > g->scores[idx].bestKills) g->scores[idx].bestKills = kills;
-    }
-    else if (g->scoreCount < SCORE_MAX) {
-        SDL_strlcpy(g->scores[g->scoreCount].name, name, NAME_MAX);
-        g->scores[g->scoreCount].bestKills = kills;
-        g->scoreCount++;
-    }
-
-    sort_scores(g);
-    save_scores(g);
+    if (g->p.dashing) return false;     // dash invuln
+    if (g->p.iFrames) return false;     // i-frames
+    return true;
 }
 
-static int best_for_name(Game* g, const char* name)
+/* ------------------ events ------------------ */
+
+// damage numbers over whoever took the hit
+static void consume_dmg_nums(Game* g, const GameEvent* ev, int n)
 {
-    int idx = find_score_index(g, name);
-    return (idx >= 0) ? g->scores[idx].bestKills : 0;
+    for (int i = 0; i < n; i++) {
+        if (ev[i].type == EVENT_ENEMY_HIT)
+            spawn_dmg(g, (Uint32)ev[i].id + 1, ev[i].gen, ev[i].x, ev[i].y, ev[i].value);
+        else if (ev[i].type == EVENT_PLAYER_HIT)
+            spawn_dmg(g, 0, 0, ev[i].x, ev[i].y, -ev[i].value);
+    }
 }
 
-/* ------------------ gameplay helpers ------------------ */
-
-static void spawn_dmg(Game* g, float x, float y, int value)
+// kill count, and the run goes on the boards when the player goes down
+static void consume_score(Game* g, const GameEvent* ev, int n)
 {
-    for (int i = 0; i < MAX_DMG_NUMS; i++) {
-        if (!g->dmgnums[i].alive) {
-            g->dmgnums[i].alive = true;
-            g->dmgnums[i].x = x;
-            g->dmgnums[i].y = y;
-            g->dmgnums[i].value = value;
-            g->dmgnums[i].t = 0.75f;
-            return;
+    for (int i = 0; i < n; i++) {
+        if (ev[i].type == EVENT_ENEMY_KILLED) g->kills++;
+        else if (ev[i].type == EVENT_PLAYER_DIED) {
+            g->lastRunKills = g->kills;
+            submit_score(g, g->playerName, g->kills);
         }
     }
 }
 
-static void update_dmgnums(Game* g, float dt)
+// every consumer takes each batch in turn, in push order
+static void dispatch_events(Game* g)
 {
-    for (int i = 0; i < MAX_DMG_NUMS; i++) {
-        if (!g->dmgnums[i].alive) continue;
-        g->dmgnums[i].t -= dt;
-        g->dmgnums[i].y -= 45.0f * dt;
-        if (g->dmgnums[i].t <= 0.0f)
-            g->dmgnums[i].alive = false;
+    GameEvent batch[EVENT_BATCH];
+    int n;
+    Events_Publish(&g->events);
+    while ((n = Events_Read(&g->events, &g->eventsGame, batch, EVENT_BATCH)) > 0) {
+        consume_dmg_nums(g, batch, n);
+        consume_score(g, batch, n);
     }
 }
 
-static bool player_can_take_damage(Game* g)
+// a big tick can outrun the ring, the game's consumers then catch up mid-step
+static void push_event(Game* g, EventType type, int id, Uint32 gen, int value, float x, float y)
 {
-    if (g->p.dashing) return false;            // dash invuln
-    if (g->p.iFrameTimer > 0.0f) return false; // i-frames
-    return true;
+    if (Events_Unread(&g->events, &g->eventsGame) >= EVENT_KEEP) dispatch_events(g);
+    GameEvent e = { type, id, gen, value, x, y };
+    Events_Push(&g->events, &e);
 }
 
 static float difficulty_scale(int kills)
@@ -156,14 +156,45 @@ static float difficulty_scale(int kills)
     return s;
 }
 
+// follows the player, held inside the world
+static void update_camera(Game* g)
+{
+    float maxX = SDL_max(g->worldW - g->viewW, 0.0f);
+    float maxY = SDL_max(g->worldH - g->viewH, 0.0f);
+    g->camX = clampf(g->p.x + g->p.size * 0.5f - g->viewW * 0.5f, 0.0f, maxX);
+    g->camY = clampf(g->p.y + g->p.size * 0.5f - g->viewH * 0.5f, 0.0f, maxY);
+}
+
+// what simulates: the streamed window, or the whole world without one
+static void update_area(Game* g)
+{
+    if (!g->stream) {
+        g->areaX = g->areaY = 0.0f;
+        g->areaW = g->worldW;
+        g->areaH = g->worldH;
+        return;
+    }
+    g->areaX = g->tiles.ox;
+    g->areaY = g->tiles.oy;
+    g->areaW = g->areaH = g->stream->chunkPx * STREAM_ACTIVE;
+}
+
+// waits for the window under the camera, outside of play only
+static void warm_stream(Game* g)
+{
+    Stream_Warm(g->stream, g->camX + g->viewW * 0.5f, g->camY + g->viewH * 0.5f, &g->tiles);
+    update_area(g);
+}
+
 static void reset_run(Game* g)
 {
     g->p.x = g->worldW * 0.5f;
     g->p.y = g->worldH * 0.5f;
+    g->p.px = g->p.x;
+    g->p.py = g->p.y;
     g->p.dx = g->p.dy = 0;
     g->p.dashing = false;
-    g->p.dashTimer = 0;
-    g->p.cooldownTimer = 0;
+    g->p.dashReady = true;
 
     g->timeSinceHit = 0.0f;
     g->regenDelay = 3.0f;
@@ -177,74 +208,171 @@ static void reset_run(Game* g)
 
     g->p.fireTimer = 0;
     g->p.reloading = false;
-    g->p.reloadTimer = 0;
+    g->p.iFrames = false;
 
-    g->p.iFrameTimer = 0.0f;
+    // pending timers belonged to the old run
+    g->clock = 0.0;
+    Timers_Clear(&g->timers, 0);
 
-    for (int i = 0; i < MAX_ENEMIES; i++) g->enemies[i].alive = false;
-    for (int i = 0; i < MAX_BULLETS; i++) g->bullets[i].alive = false;
-    for (int i = 0; i < MAX_EBULLETS; i++) g->ebullets[i].alive = false;
-    for (int i = 0; i < MAX_DMG_NUMS; i++) g->dmgnums[i].alive = false;
+    for (int i = 0; i < g->maxEnemies; i++) g->enemies[i].alive = false;
+    for (int i = 0; i < g->maxBullets; i++) g->bullets[i].alive = false;
+    g->eb.count = 0;
+    g->dmgCount = 0;
 
     g->spawnTimer = 0.35f;
     g->hit = false;
     g->hitDmg = 14;
     g->kills = 0;
+    update_camera(g);
+
+    // a new run starts back in the middle, its chunks are loaded before play
+    if (g->stream) warm_stream(g);
 }
 
+/* ------------------ archetypes ------------------ */
+
+// how a type moves, one batch loop per kind in the move pass
+typedef enum {
+    MOVE_CHASE = 0,     // straight at the player, around walls on the flow field
+    MOVE_ARCHER = 1,    // keeps its distance, strafes, winds up and shoots
+    MOVE_KIND_COUNT
+} MoveKind;
+
+// everything that differs per type. a new type is an entry here,
+// and a MoveKind with its batch loop if it moves like none of these
+typedef struct {
+    float size;
+    float speed;
+    int hp;
+    int touchDmg;
+    float shootCooldown;    // 0 = never shoots
+    float shootTimer;       // first shot
+
+    // separation: radius around the center and how hard it steers
+    // away (share of its own speed). tanks barely budge, archers spread wide
+    float crowdRadius;
+    float crowdPush;
+
+    MoveKind move;
+
+    // stress mode: archers spiral, tanks fire rings
+    EmitKind emit;
+    int emitCount;
+    float emitInterval;
+    float emitTurn;
+    float emitSpeed;
+
+    SDL_Color color;
+} Archetype;
+
+static const Archetype ARCHETYPES[ENEMY_TYPE_COUNT] = {
+    [ENEMY_GRUNT] = {
+        .size = 28.0f, .speed = 125.0f, .hp = 50, .touchDmg = 14,
+        .crowdRadius = 34.0f, .crowdPush = 0.85f, .move = MOVE_CHASE,
+        .color = { 200, 60, 60, 255 },
+    },
+    [ENEMY_RUNNER] = {
+        .size = 18.0f, .speed = 245.0f, .hp = 25, .touchDmg = 12,
+        .crowdRadius = 24.0f, .crowdPush = 0.55f, .move = MOVE_CHASE,
+        .color = { 240, 110, 110, 255 },
+    },
+    [ENEMY_TANK] = {
+        .size = 44.0f, .speed = 88.0f, .hp = 150, .touchDmg = 24,
+        .crowdRadius = 52.0f, .crowdPush = 0.25f, .move = MOVE_CHASE,
+        .emit = EMIT_RADIAL, .emitCount = 36, .emitInterval = 0.3f,
+        .emitTurn = 3.14159265f / 36.0f, .emitSpeed = 150.0f,
+        .color = { 160, 50, 50, 255 },
+    },
+    [ENEMY_ARCHER] = {
+        .size = 24.0f, .speed = 105.0f, .hp = 45, .touchDmg = 14,
+        .shootCooldown = 1.35f, .shootTimer = 0.55f,
+        .crowdRadius = 56.0f, .crowdPush = 0.70f, .move = MOVE_ARCHER,
+        .emit = EMIT_SPIRAL, .emitCount = 5, .emitInterval = 0.03f,
+        .emitTurn = 0.19f, .emitSpeed = 170.0f,
+        .color = { 140, 220, 140, 255 },
+    },
+};
+
 static void init_enemy_by_type(Enemy* e, EnemyType t)
 {
+    if ((unsigned)t >= ENEMY_TYPE_COUNT) t = ENEMY_GRUNT;
+    const Archetype* a = &ARCHETYPES[t];
+
     e->type = t;
     e->alive = true;
 
-    e->shootTimer = 0.0f;
-    e->shootCooldown = 0.0f;
+    e->size = a->size;
+    e->speed = a->speed;
+    e->hp = a->hp;
+    e->touchDmg = a->touchDmg;
+    e->shootCooldown = a->shootCooldown;
+    e->shootReady = false;
+    e->gen++;
+
     e->strafeDir = 0.0f;
-    e->strafeTimer = 0.0f;
-    e->windup = 0.0f;
+    e->windup = false;
+    e->windupReq = false;
+    e->shotReq = false;
+    e->los = true;
+    e->losWait = 0;
+    e->aiDt = 0.0f;
+    e->emit = EMIT_NONE;
+    e->emitReq = 0;
+
+    if (a->move == MOVE_ARCHER) {
+        e->strafeDir = (rand() % 2) ? 1.0f : -1.0f;
+        e->rng = ((Uint64)rand() << 32) ^ (Uint64)rand();
+    }
+}
 
-    switch (t) {
-    default:
-    case ENEMY_GRUNT:
-        e->size = 28.0f;
-        e->speed = 125.0f;
-        e->hp = 50;
-        e->touchDmg = 14;
-        break;
+// stress mode, types without an emitter stay plain
+static void init_emitter(Enemy* e)
+{
+    const Archetype* a = &ARCHETYPES[e->type];
+    if (a->emit == EMIT_NONE) return;
+
+    e->emit = a->emit;
+    e->emitCount = a->emitCount;
+    e->emitInterval = a->emitInterval;
+    e->emitTurn = a->emitTurn;
+    e->emitSpeed = a->emitSpeed;
+    e->emitAngle = (rand() % 628) / 100.0f;
+}
 
-    case ENEMY_RUNNER:
-        e->size = 18.0f;
-        e->speed = 245.0f;
-        e->hp = 25;
-        e->touchDmg = 12;
-        break;
+static float strafe_time(Enemy* e)
+{
+    return 0.6f + SDL_rand_r(&e->rng, 60) / 100.0f;
+}
 
-    case ENEMY_TANK:
-        e->size = 44.0f;
-        e->speed = 88.0f;
-        e->hp = 150;
-        e->touchDmg = 24;
-        break;
+// first shot, strafe turn and burst, each reschedules itself when it fires
+static void start_enemy_timers(Game* g, Enemy* e)
+{
+    Uint32 id = (Uint32)(e - g->enemies);
+    const Archetype* a = &ARCHETYPES[e->type];
+    if (a->shootCooldown > 0.0f) schedule(g, TIMER_SHOOT, id, e->gen, a->shootTimer);
+    if (a->move == MOVE_ARCHER) schedule(g, TIMER_STRAFE, id, e->gen, strafe_time(e));
+    if (e->emit != EMIT_NONE) schedule(g, TIMER_EMIT, id, e->gen, e->emitInterval);
+}
 
-    case ENEMY_ARCHER:
-        e->size = 24.0f;
-        e->speed = 105.0f;
-        e->hp = 45;
-        e->touchDmg = 14;
+// type stats, stress emitter and the difficulty ramp
+static void setup_enemy(Game* g, Enemy* e, EnemyType t)
+{
+    init_enemy_by_type(e, t);
+    if (g->mode == MODE_STRESS) init_emitter(e);
 
-        e->shootCooldown = 1.35f;
-        e->shootTimer = 0.55f;
+    float s = difficulty_scale(g->kills);
+    e->speed *= s;
 
-        e->strafeDir = (rand() % 2) ? 1.0f : -1.0f;
-        e->strafeTimer = 0.6f + (rand() % 60) / 100.0f;
-        e->windup = 0.0f;
-        break;
+    if (e->shootCooldown > 0.0f) {
+        e->shootCooldown /= (0.85f + 0.15f * s);
+        if (e->shootCooldown < 0.55f) e->shootCooldown = 0.55f;
     }
+    start_enemy_timers(g, e);
 }
 
 static void spawn_enemy(Game* g)
 {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
+    for (int i = 0; i < g->maxEnemies; i++) {
         if (g->enemies[i].alive) continue;
 
         Enemy* e = &g->enemies[i];
@@ -252,7 +380,14 @@ static void spawn_enemy(Game* g)
         int roll = rand() % 100;
         EnemyType t = ENEMY_GRUNT;
 
-        if (g->kills < 5) {
+        if (g->mode == MODE_STRESS) {
+            // half of them emitters from the start
+            if (roll < 30) t = ENEMY_GRUNT;
+            else if (roll < 50) t = ENEMY_RUNNER;
+            else if (roll < 75) t = ENEMY_ARCHER;
+            else t = ENEMY_TANK;
+        }
+        else if (g->kills < 5) {
             if (roll < 85) t = ENEMY_GRUNT;
             else if (roll < 97) t = ENEMY_RUNNER;
             else t = ENEMY_ARCHER;
@@ -270,29 +405,76 @@ static void spawn_enemy(Game* g)
             else t = ENEMY_TANK;
         }
 
-        init_enemy_by_type(e, t);
-
-        float s = difficulty_scale(g->kills);
-        e->speed *= s;
-
-        if (e->type == ENEMY_ARCHER) {
-            e->shootCooldown /= (0.85f + 0.15f * s);
-            if (e->shootCooldown < 0.55f) e->shootCooldown = 0.55f;
-        }
+        setup_enemy(g, e, t);
 
+        // just off screen, the camera is the whole world in a normal arena
+        float cx = g->camX, cy = g->camY;
         int edge = rand() % 4;
-        if (edge == 0) { e->x = -e->size;  e->y = (float)(rand() % (int)g->worldH); }
-        if (edge == 1) { e->x = g->worldW; e->y = (float)(rand() % (int)g->worldH); }
-        if (edge == 2) { e->x = (float)(rand() % (int)g->worldW); e->y = -e->size; }
-        if (edge == 3) { e->x = (float)(rand() % (int)g->worldW); e->y = g->worldH; }
+        if (edge == 0) { e->x = cx - e->size;  e->y = cy + (float)(rand() % (int)g->viewH); }
+        if (edge == 1) { e->x = cx + g->viewW; e->y = cy + (float)(rand() % (int)g->viewH); }
+        if (edge == 2) { e->x = cx + (float)(rand() % (int)g->viewW); e->y = cy - e->size; }
+        if (edge == 3) { e->x = cx + (float)(rand() % (int)g->viewW); e->y = cy + g->viewH; }
 
-        float base = 1.0f;
+        float base = (g->mode == MODE_STRESS) ? 0.08f : 1.0f;
         float faster = (g->kills > 20) ? 0.75f : (g->kills > 10 ? 0.85f : 1.0f);
         g->spawnTimer = base * faster;
         return;
     }
 }
 
+// centred on (x, y), false when the pool is full
+static bool spawn_enemy_at(Game* g, EnemyType t, float x, float y)
+{
+    for (int i = 0; i < g->maxEnemies; i++) {
+        Enemy* e = &g->enemies[i];
+        if (e->alive) continue;
+
+        setup_enemy(g, e, t);
+        e->x = x - e->size * 0.5f;
+        e->y = y - e->size * 0.5f;
+        return true;
+    }
+    return false;
+}
+
+/* ------------------ streamed world ------------------ */
+
+// dormant spawners wake up with their chunk. they only spawn off screen,
+// an active chunk's spawner in view just waits for the camera to move on
+static void tick_spawners(Game* g, float dt)
+{
+    WorldStream* s = g->stream;
+    for (int k = 0; k < STREAM_ACTIVE * STREAM_ACTIVE; k++) {
+        if (s->active[k] < 0) continue;
+        ChunkSlot* c = &s->slots[s->active[k]];
+        for (int i = 0; i < c->spawnerCount; i++) {
+            ChunkSpawner* sp = &c->spawners[i];
+            if (sp->left <= 0) continue;
+            sp->timer -= dt;
+            if (sp->timer > 0.0f) continue;
+
+            bool inView = sp->x > g->camX - SPAWNER_MARGIN && sp->x < g->camX + g->viewW + SPAWNER_MARGIN &&
+                          sp->y > g->camY - SPAWNER_MARGIN && sp->y < g->camY + g->viewH + SPAWNER_MARGIN;
+            if (inView) continue;
+
+            EnemyType t = (EnemyType)(sp->type % ENEMY_TYPE_COUNT);
+            if (!spawn_enemy_at(g, t, sp->x, sp->y)) continue;
+            sp->left--;
+            sp->timer = sp->interval;
+        }
+    }
+}
+
+// moves the window with the camera, loads ahead of where the player walks
+static void update_stream(Game* g)
+{
+    const Player* p = &g->p;
+    float cx = g->camX + g->viewW * 0.5f, cy = g->camY + g->viewH * 0.5f;
+    float ahead = (p->dashing ? p->dashSpeed : p->speed) * STREAM_LOOKAHEAD;
+    if (Stream_Update(g->stream, cx, cy, cx + p->dx * ahead, cy + p->dy * ahead, &g->tiles))
+        update_area(g);
+}
+
 static void do_reload(Game* g)
 {
     int need = g->p.magMax - g->p.mag;
@@ -317,62 +499,692 @@ static void start_reload(Game* g)
     if (g->p.reserve == 0) return;
 
     g->p.reloading = true;
-    g->p.reloadTimer = g->p.reloadTime;
+    g->p.reloadDone = g->clock + (double)g->p.reloadTime;
+    schedule(g, TIMER_RELOAD, 0, 0, g->p.reloadTime);
 }
 
-static void fire_bullet(Game* g, float dirx, float diry)
+// age = how long ago the shot was due, the bullet starts where it would be by
+// now from where the player was then, its swept path starts at the muzzle
+static bool fire_bullet(Game* g, float ox, float oy, float dirx, float diry, float age)
 {
-    if (g->p.reloading) return;
-    if (g->p.mag <= 0) return;
+    if (g->p.reloading) return false;
+    if (g->p.mag <= 0) return false;
 
-    for (int i = 0; i < MAX_BULLETS; i++) {
+    for (int i = 0; i < g->maxBullets; i++) {
         if (!g->bullets[i].alive) {
             Bullet* b = &g->bullets[i];
             b->alive = true;
-
-            float px = g->p.x + g->p.size * 0.5f;
-            float py = g->p.y + g->p.size * 0.5f;
-
-            b->x = px;
-            b->y = py;
             b->r = 4.0f;
 
             float speed = 900.0f;
             b->vx = dirx * speed;
             b->vy = diry * speed;
 
+            b->px = ox;
+            b->py = oy;
+            b->x = ox + b->vx * age;
+            b->y = oy + b->vy * age;
+            b->fresh = true;
+
             g->p.mag--;
-            g->p.fireTimer = g->p.fireCooldown;
+            push_event(g, EVENT_SHOT_FIRED, i, 0, 0, ox, oy);
 
             if (g->p.mag == 0) start_reload(g);
-            return;
+            return true;
         }
     }
+    return false;
 }
 
-static void spawn_enemy_bullet(Game* g, float x, float y, float dirx, float diry, int dmg)
+static void spawn_enemy_bullet(Game* g, float x, float y, float dirx, float diry, float speed, int dmg)
 {
-    for (int i = 0; i < MAX_EBULLETS; i++) {
-        if (g->ebullets[i].alive) continue;
+    EBulletPool* eb = &g->eb;
+    if (eb->count >= eb->cap) return;
+
+    int i = eb->count++;
+    eb->alive[i] = true;
+    eb->x[i] = eb->px[i] = x;
+    eb->y[i] = eb->py[i] = y;
+    eb->vx[i] = dirx * speed;
+    eb->vy[i] = diry * speed;
+    eb->dmg[i] = dmg;
+}
 
-        EnemyBullet* b = &g->ebullets[i];
-        b->alive = true;
-        b->x = x;
-        b->y = y;
-        b->r = 3.5f;
-        b->dmg = dmg;
+// squeezes out dead bullets, keeps the live ones in order (deterministic)
+static void compact_ebullets(EBulletPool* eb)
+{
+    int n = 0;
+    for (int i = 0; i < eb->count; i++) {
+        if (!eb->alive[i]) continue;
+        if (n != i) {
+            eb->x[n] = eb->x[i];
+            eb->y[n] = eb->y[i];
+            eb->px[n] = eb->px[i];
+            eb->py[n] = eb->py[i];
+            eb->vx[n] = eb->vx[i];
+            eb->vy[n] = eb->vy[i];
+            eb->dmg[n] = eb->dmg[i];
+            eb->alive[n] = true;
+        }
+        n++;
+    }
+    eb->count = n;
+}
 
-        float speed = 470.0f;
-        b->vx = dirx * speed;
-        b->vy = diry * speed;
-        return;
+static void free_ebullets(EBulletPool* eb)
+{
+    SDL_free(eb->x);
+    SDL_free(eb->y);
+    SDL_free(eb->px);
+    SDL_free(eb->py);
+    SDL_free(eb->vx);
+    SDL_free(eb->vy);
+    SDL_free(eb->dmg);
+    SDL_free(eb->alive);
+    SDL_zerop(eb);
+}
+
+static bool alloc_ebullets(EBulletPool* eb, int cap)
+{
+    SDL_zerop(eb);
+    size_t n = (size_t)cap;
+    eb->x = (float*)SDL_calloc(n, sizeof(float));
+    eb->y = (float*)SDL_calloc(n, sizeof(float));
+    eb->px = (float*)SDL_calloc(n, sizeof(float));
+    eb->py = (float*)SDL_calloc(n, sizeof(float));
+    eb->vx = (float*)SDL_calloc(n, sizeof(float));
+    eb->vy = (float*)SDL_calloc(n, sizeof(float));
+    eb->dmg = (int*)SDL_calloc(n, sizeof(int));
+    eb->alive = (bool*)SDL_calloc(n, sizeof(bool));
+    if (!eb->x || !eb->y || !eb->px || !eb->py || !eb->vx || !eb->vy || !eb->dmg || !eb->alive) {
+        free_ebullets(eb);
+        return false;
+    }
+    eb->cap = cap;
+    return true;
+}
+
+static void damage_player(Game* g, int dmg)
+{
+    Player* p = &g->p;
+    p->hp -= dmg;
+
+    p->iFrames = true;
+    schedule(g, TIMER_IFRAMES, 0, 0, p->iFrameTime);
+    g->timeSinceHit = 0.0f;
+    g->regenAcc = 0.0f;
+
+    push_event(g, EVENT_PLAYER_HIT, 0, 0, dmg, p->x + p->size * 0.5f, p->y - 6.0f);
+
+    if (p->hp <= 0) {
+        p->hp = 0;
+        g->state = GAME_DEAD;
+
+        // submit score on d
+        push_event(g, EVENT_PLAYER_DIED, 0, 0, 0, p->x + p->size * 0.5f, p->y + p->size * 0.5f);
+    }
+}
+
+typedef struct {
+    float sx, sy;
+    int seen;       // neighbours inside the radius
+    int scanned;    // entries looked at, bounds the work in a dense pile
+} CrowdSum;
+
+// weight (1 - d / r) / d, falls off to 0 at the radius
+static void crowd_cell(const Grid* gr, int cell, int i, float cx, float cy, float r, CrowdSum* s)
+{
+    float invR = 1.0f / r;
+
+    for (int k = gr->start[cell]; k < gr->start[cell + 1]; k++) {
+        if (s->seen == CROWD_MAX_NEIGHBORS || s->scanned == CROWD_MAX_SCAN) return;
+        s->scanned++;
+
+        int j = gr->slot[k];
+        if (j == i) continue;
+
+        float dx = cx - gr->x[k];
+        float dy = cy - gr->y[k];
+        float d2 = dx * dx + dy * dy;
+        if (d2 >= r * r) continue;
+
+        if (d2 > 0.0f) {
+            float w = 1.0f / SDL_sqrtf(d2) - invR;
+            s->sx += dx * w;
+            s->sy += dy * w;
+        }
+        else {
+            // dead on top of each other, split them by slot
+            s->sx += (i < j) ? -1.0f : 1.0f;
+        }
+        s->seen++;
+    }
+}
+
+// boids separation off the start-of-tick grid, so it only reads shared state
+// and the result doesn't depend on which thread moved whom first
+static void crowd_push(const Game* g, int i, const Enemy* en, float dt, float* outX, float* outY)
+{
+    const Grid* gr = &g->crowd;
+    const Archetype* a = &ARCHETYPES[en->type];
+    float r = a->crowdRadius;
+    float cx = en->x + en->size * 0.5f;
+    float cy = en->y + en->size * 0.5f;
+
+    int oc, orow, c0, r0, c1, r1;
+    Grid_Range(gr, cx, cy, cx, cy, &oc, &orow, &oc, &orow);
+    Grid_Range(gr, cx - r, cy - r, cx + r, cy + r, &c0, &r0, &c1, &r1);
+
+    // own cell first, the closest ones are most likely there
+    CrowdSum sum = { 0 };
+    int own = orow * gr->cols + oc;
+    crowd_cell(gr, own, i, cx, cy, r, &sum);
+    for (int row = r0; row <= r1; row++) {
+        for (int col = c0; col <= c1; col++) {
+            int cell = row * gr->cols + col;
+            if (cell != own) crowd_cell(gr, cell, i, cx, cy, r, &sum);
+        }
+    }
+
+    float len = SDL_sqrtf(sum.sx * sum.sx + sum.sy * sum.sy);
+    if (len > 1.0f) { sum.sx /= len; sum.sy /= len; }
+
+    float step = a->crowdPush * en->speed * dt;
+    *outX = sum.sx * step;
+    *outY = sum.sy * step;
+}
+
+// flow = NULL when there's no field this tick, offscreen = past LOD_MARGIN
+static void move_archer(Game* g, Enemy* en, const FlowField* flow, bool offscreen,
+                        float pcx, float pcy, float dt)
+{
+    float ecx = en->x + en->size * 0.5f;
+    float ecy = en->y + en->size * 0.5f;
+
+    float toPx = pcx - ecx;
+    float toPy = pcy - ecy;
+    float dist = SDL_sqrtf(toPx * toPx + toPy * toPy);
+    float nx = 0.0f, ny = 0.0f;
+    if (dist > 0.0f) { nx = toPx / dist; ny = toPy / dist; }
+
+    float desired = 240.0f;
+    float moveX = 0.0f, moveY = 0.0f;
+
+    if (dist < desired - 30.0f) {
+        moveX -= nx; moveY -= ny;
+    }
+    else if (dist > desired + 60.0f) {
+        moveX += nx * 0.55f; moveY += ny * 0.55f;
+    }
+
+    float pxp = -ny;
+    float pyp = nx;
+    moveX += pxp * en->strafeDir * 0.75f;
+    moveY += pyp * en->strafeDir * 0.75f;
+
+    // out of sight behind a wall: walk the field until the player shows up
+    if (!en->los && flow) {
+        int cell = Flow_Cell(flow, ecx, ecy);
+        if (flow->dx[cell] != 0.0f || flow->dy[cell] != 0.0f) {
+            moveX = flow->dx[cell];
+            moveY = flow->dy[cell];
+        }
+    }
+
+    float ml = SDL_sqrtf(moveX * moveX + moveY * moveY);
+    if (ml > 0.0f) { moveX /= ml; moveY /= ml; }
+
+    en->x += moveX * en->speed * dt;
+    en->y += moveY * en->speed * dt;
+
+    en->x = clampf(en->x, 0.0f, g->worldW - en->size);
+    en->y = clampf(en->y, 0.0f, g->worldH - en->size);
+
+    // ready once its cooldown timer went off. the windup goes on the shared wheel, resolve starts it
+    if (en->shootReady && en->los && !offscreen) en->windupReq = true;
+}
+
+static void emit_bursts(Game* g, Enemy* en)
+{
+    float cx = en->x + en->size * 0.5f;
+    float cy = en->y + en->size * 0.5f;
+    float step = 6.2831853f / (float)en->emitCount;
+
+    for (; en->emitReq > 0; en->emitReq--) {
+        for (int k = 0; k < en->emitCount; k++) {
+            float a = en->emitAngle + step * (float)k;
+            spawn_enemy_bullet(g, cx, cy, SDL_cosf(a), SDL_sinf(a), en->emitSpeed, STRESS_DMG);
+        }
+        en->emitAngle += en->emitTurn;
+    }
+}
+
+// the move above ignored walls, walk it again through them from px/py
+static void settle_enemy(const TileMap* t, Enemy* en)
+{
+    if (!t->solid) return;
+    float dx = en->x - en->px;
+    float dy = en->y - en->py;
+    en->x = en->px;
+    en->y = en->py;
+    Tiles_Move(t, &en->x, &en->y, en->size, en->size, dx, dy);
+}
+
+/* ------------------ parallel passes ------------------ */
+
+typedef struct {
+    Game* g;
+    float dt;
+    float pcx, pcy;
+    bool crowd;  // separation grid is built
+    bool flow;   // flow field points at the player
+    float nearX0, nearY0, nearX1, nearY1;   // camera + LOD_MARGIN
+    // far AI LOD, 0 = everyone every tick. far enemies think when
+    // (slot + aiTick) % aiPeriod == 0, far[] counts them per chunk
+    int aiPeriod;
+    Uint32 aiTick;
+    int far[PAR_CHUNKS];
+
+    int count;   // slots in the current pass
+    int per;     // slots per chunk
+    int chunks;
+} PassCtx;
+
+// ticks between a far enemy's updates, at most AI_FAR_BUDGET of them think per tick
+static int ai_period(int far)
+{
+    return SDL_max(AI_FAR_TICKS, (far + AI_FAR_BUDGET - 1) / AI_FAR_BUDGET);
+}
+
+static bool is_offscreen(const PassCtx* c, const Enemy* en)
+{
+    float x = en->x + en->size * 0.5f;
+    float y = en->y + en->size * 0.5f;
+    return x < c->nearX0 || x > c->nearX1 || y < c->nearY0 || y > c->nearY1;
+}
+
+static void chunk_range(const PassCtx* c, int chunk, int* begin, int* end)
+{
+    *begin = chunk * c->per;
+    *end = *begin + c->per;
+    if (*end > c->count) *end = c->count;
+}
+
+static void job_bullets(void* ctx, int chunk)
+{
+    PassCtx* c = (PassCtx*)ctx;
+    Game* g = c->g;
+    float dt = c->dt;
+
+    int begin, end;
+    chunk_range(c, chunk, &begin, &end);
+
+    for (int i = begin; i < end; i++) {
+        Bullet* b = &g->bullets[i];
+        if (!b->alive) continue;
+
+        if (b->fresh) {
+            b->fresh = false;
+        }
+        else {
+            b->px = b->x;
+            b->py = b->y;
+            b->x += b->vx * dt;
+            b->y += b->vy * dt;
+        }
+
+        if (b->x < g->areaX - 50 || b->x > g->areaX + g->areaW + 50 ||
+            b->y < g->areaY - 50 || b->y > g->areaY + g->areaH + 50)
+            b->alive = false;
+        // dt varies, a long tick can carry it past a whole tile, so the
+        // segment it moved along is tested and not only where it ended up
+        if (Tiles_Solid(&g->tiles, b->x, b->y) ||
+            !Tiles_Visible(&g->tiles, b->px, b->py, b->x, b->y))
+            b->alive = false;
+    }
+}
+
+static void job_ebullets(void* ctx, int chunk)
+{
+    PassCtx* c = (PassCtx*)ctx;
+    Game* g = c->g;
+    float dt = c->dt;
+
+    int begin, end;
+    chunk_range(c, chunk, &begin, &end);
+
+    // pool is packed, every slot up to count is live here
+    EBulletPool* eb = &g->eb;
+    g->kern.integrate(eb->x + begin, eb->y + begin, eb->px + begin, eb->py + begin,
+                      eb->vx + begin, eb->vy + begin, eb->alive + begin, end - begin,
+                      dt, g->areaX - 60.0f, g->areaY - 60.0f,
+                      g->areaX + g->areaW + 60, g->areaY + g->areaH + 60);
+
+    if (!g->tiles.solid) return;
+    for (int i = begin; i < end; i++) {
+        if (!eb->alive[i]) continue;
+        if (Tiles_Solid(&g->tiles, eb->x[i], eb->y[i]) ||
+            !Tiles_Visible(&g->tiles, eb->px[i], eb->py[i], eb->x[i], eb->y[i]))
+            eb->alive[i] = false;
+    }
+}
+
+static bool outside_area(const Game* g, const Enemy* en)
+{
+    float cx = en->x + en->size * 0.5f, cy = en->y + en->size * 0.5f;
+    return cx < g->areaX || cy < g->areaY || cx >= g->areaX + g->areaW || cy >= g->areaY + g->areaH;
+}
+
+// enemies of one move kind from a chunk, with what the shared part of
+// the pass worked out for each. every kind has its own loop over these
+typedef struct {
+    int idx[MOVE_BLOCK];
+    float dt[MOVE_BLOCK];       // tick dt plus what the far LOD banked
+    float sepX[MOVE_BLOCK], sepY[MOVE_BLOCK];
+    bool offscreen[MOVE_BLOCK];
+    int n;
+} MoveBatch;
+
+typedef void (*MoveBatchFn)(Game* g, const PassCtx* c, const MoveBatch* b);
+
+// detour cells walk the field, open ones go through the chase kernel on
+// flat copies. the kernel shares one dt, a catch-up step goes faster instead
+static void move_chasers(Game* g, const PassCtx* c, const MoveBatch* b)
+{
+    float x[MOVE_BLOCK], y[MOVE_BLOCK], speed[MOVE_BLOCK];
+    int lane[MOVE_BLOCK];   // batch entry of each kernel lane
+    int n = 0;
+
+    for (int k = 0; k < b->n; k++) {
+        Enemy* en = &g->enemies[b->idx[k]];
+        float dt = b->dt[k];
+
+        if (c->flow) {
+            int cell = Flow_Cell(&g->flow, en->x + en->size * 0.5f, en->y + en->size * 0.5f);
+            float fx = g->flow.dx[cell], fy = g->flow.dy[cell];
+            if (fx != 0.0f || fy != 0.0f) {
+                en->x += fx * en->speed * dt + b->sepX[k];
+                en->y += fy * en->speed * dt + b->sepY[k];
+                settle_enemy(&g->tiles, en);
+                continue;
+            }
+        }
+
+        lane[n] = k;
+        x[n] = en->x;
+        y[n] = en->y;
+        speed[n] = (dt != c->dt && c->dt > 0.0f) ? en->speed * (dt / c->dt) : en->speed;
+        n++;
+    }
+    if (n == 0) return;
+
+    g->kern.chase(x, y, speed, n, g->p.x, g->p.y, c->dt);
+    for (int j = 0; j < n; j++) {
+        int k = lane[j];
+        Enemy* en = &g->enemies[b->idx[k]];
+        en->x = x[j] + b->sepX[k];
+        en->y = y[j] + b->sepY[k];
+        settle_enemy(&g->tiles, en);
+    }
+}
+
+static void move_archers(Game* g, const PassCtx* c, const MoveBatch* b)
+{
+    const FlowField* flow = c->flow ? &g->flow : NULL;
+    for (int k = 0; k < b->n; k++) {
+        Enemy* en = &g->enemies[b->idx[k]];
+        move_archer(g, en, flow, b->offscreen[k], c->pcx, c->pcy, b->dt[k]);
+        en->x = clampf(en->x + b->sepX[k], 0.0f, g->worldW - en->size);
+        en->y = clampf(en->y + b->sepY[k], 0.0f, g->worldH - en->size);
+        settle_enemy(&g->tiles, en);
+    }
+}
+
+static const MoveBatchFn MOVES[MOVE_KIND_COUNT] = {
+    [MOVE_CHASE]  = move_chasers,
+    [MOVE_ARCHER] = move_archers,
+};
+
+// shared part per slot (LOD, emitter, separation), then each enemy joins
+// its kind's batch. enemies only write themselves, so the order kinds
+// run in doesn't change the result
+static void job_move_enemies(void* ctx, int chunk)
+{
+    PassCtx* c = (PassCtx*)ctx;
+    Game* g = c->g;
+
+    int begin, end;
+    chunk_range(c, chunk, &begin, &end);
+
+    MoveBatch batch[MOVE_KIND_COUNT];
+    for (int m = 0; m < MOVE_KIND_COUNT; m++) batch[m].n = 0;
+    c->far[chunk] = 0;
+
+    // (i + aiTick) % period, stepped along instead of divided per slot
+    int period = SDL_max(c->aiPeriod, 1);
+    int phase = (int)(((Uint32)begin + c->aiTick) % (Uint32)period);
+
+    for (int i = begin; i < end; i++, phase = (phase + 1 == period) ? 0 : phase + 1) {
+        Enemy* en = &g->enemies[i];
+        if (!en->alive) continue;
+        en->px = en->x;
+        en->py = en->y;
+
+        // walked off the active chunks, it goes dormant with them
+        if (g->stream && outside_area(g, en)) {
+            en->alive = false;
+            continue;
+        }
+
+        // far ones skip ticks and catch up on the banked time when due
+        bool offscreen = is_offscreen(c, en);
+        if (offscreen) {
+            c->far[chunk]++;
+            if (phase != 0) {
+                en->aiDt += c->dt;
+                continue;
+            }
+        }
+        float dt = c->dt + en->aiDt;
+        en->aiDt = 0.0f;
+
+        float sepX = 0.0f, sepY = 0.0f;
+        if (c->crowd && !offscreen) crowd_push(g, i, en, c->dt, &sepX, &sepY);
+
+        MoveKind m = ARCHETYPES[en->type].move;
+        MoveBatch* b = &batch[m];
+        b->idx[b->n] = i;
+        b->dt[b->n] = dt;
+        b->sepX[b->n] = sepX;
+        b->sepY[b->n] = sepY;
+        b->offscreen[b->n] = offscreen;
+        if (++b->n == MOVE_BLOCK) {
+            MOVES[m](g, c, b);
+            b->n = 0;
+        }
+    }
+
+    for (int m = 0; m < MOVE_KIND_COUNT; m++)
+        if (batch[m].n) MOVES[m](g, c, &batch[m]);
+}
+
+// archers due a sight check, gathered so one batch query serves a block
+typedef struct {
+    int idx[LOS_BLOCK];
+    float x[LOS_BLOCK], y[LOS_BLOCK];
+    int n;
+} SightBlock;
+
+static void flush_sight(Game* g, SightBlock* sb, float pcx, float pcy)
+{
+    Uint32 mask[LOS_BLOCK / 32];
+    Tiles_VisibleBatch(&g->tiles, sb->x, sb->y, sb->n, pcx, pcy, mask);
+    for (int k = 0; k < sb->n; k++)
+        g->enemies[sb->idx[k]].los = (mask[k >> 5] >> (k & 31)) & 1u;
+    sb->n = 0;
+}
+
+// cached for LOS_TICKS, spawns staggered the waits already
+static void job_archer_los(void* ctx, int chunk)
+{
+    PassCtx* c = (PassCtx*)ctx;
+    Game* g = c->g;
+
+    int begin, end;
+    chunk_range(c, chunk, &begin, &end);
+
+    SightBlock sb;
+    sb.n = 0;
+
+    for (int i = begin; i < end; i++) {
+        Enemy* en = &g->enemies[i];
+        if (!en->alive || en->type != ENEMY_ARCHER) continue;
+        // off screen they don't shoot, no ray until they come back
+        if (is_offscreen(c, en)) {
+            en->los = false;
+            en->losWait = 0;
+            continue;
+        }
+        if (en->losWait > 0) {
+            en->losWait--;
+            continue;
+        }
+        en->losWait = LOS_TICKS - 1;
+
+        sb.idx[sb.n] = i;
+        sb.x[sb.n] = en->x + en->size * 0.5f;
+        sb.y[sb.n] = en->y + en->size * 0.5f;
+        if (++sb.n == LOS_BLOCK) flush_sight(g, &sb, c->pcx, c->pcy);
+    }
+    if (sb.n) flush_sight(g, &sb, c->pcx, c->pcy);
+}
+
+static void job_detect_ebullets(void* ctx, int chunk)
+{
+    PassCtx* c = (PassCtx*)ctx;
+    ContactList* out = &c->g->chunkContacts[chunk];
+    out->count = 0;
+
+    int begin, end;
+    chunk_range(c, chunk, &begin, &end);
+    Contacts_DetectEBullets(c->g, begin, end, out);
+}
+
+static void job_detect_enemies(void* ctx, int chunk)
+{
+    PassCtx* c = (PassCtx*)ctx;
+    ContactList* out = &c->g->chunkContacts[chunk];
+    out->count = 0;
+
+    int begin, end;
+    chunk_range(c, chunk, &begin, &end);
+    Contacts_DetectEnemies(c->g, begin, end, out);
+}
+
+// crowd grid from where everyone starts the tick, also what the snapshot culls with
+static bool index_enemies(Game* g)
+{
+    Enemy* e0 = g->enemies;
+    return Grid_Build(&g->crowd, CROWD_CELL, g->areaX, g->areaY, g->areaW, g->areaH,
+                      &e0->x, &e0->y, &e0->size, &e0->alive, sizeof(Enemy), g->maxEnemies);
+}
+
+// weight = rough cost of one slot, small passes never leave this thread
+static void run_pass(Game* g, PassCtx* c, int count, int weight, JobFn fn)
+{
+    int chunks = 1;
+    if (g->jobs && (long long)count * weight >= PAR_MIN_WORK) {
+        chunks = Jobs_Threads(g->jobs) * 4;
+        if (chunks > PAR_CHUNKS) chunks = PAR_CHUNKS;
+        if (chunks > count) chunks = count;
     }
+
+    c->count = count;
+    c->chunks = chunks;
+    c->per = (count + chunks - 1) / chunks;
+    Jobs_Run(g->jobs, chunks, fn, c);
+}
+
+// chunk order = slot order, so the joined list doesn't depend on scheduling
+static void join_contacts(Game* g, const PassCtx* c)
+{
+    for (int i = 0; i < c->chunks; i++)
+        Contacts_Append(&g->contacts, &g->chunkContacts[i]);
 }
 
-static void center_panel(SDL_Renderer* r, float w, float h, float worldW, float worldH)
+// applies the sorted contact list plus the archer requests,
+// same order the old single pass mutated things in
+static void resolve_contacts(Game* g)
 {
-    float x = (worldW - w) * 0.5f;
-    float y = (worldH - h) * 0.5f;
+    ContactList* cl = &g->contacts;
+    Contacts_Sort(cl);
+
+    const Contact* c = cl->items;
+    const Contact* end = c + cl->count;
+
+    for (; c < end && c->type == CONTACT_EBULLET_PLAYER; c++) {
+        if (player_can_take_damage(g)) damage_player(g, g->eb.dmg[c->a]);
+        g->eb.alive[c->a] = false;
+    }
+
+    g->hit = false;
+    g->hitDmg = 14;
+
+    for (int i = 0; i < g->maxEnemies; i++) {
+        Enemy* en = &g->enemies[i];
+
+        if (en->windupReq) {
+            float s = difficulty_scale(g->kills);
+            float windup = 0.22f - 0.06f * (s - 1.0f);
+            if (windup < 0.14f) windup = 0.14f;
+            schedule(g, TIMER_WINDUP, (Uint32)i, en->gen, windup);
+            en->windup = true;
+            en->shootReady = false;
+            en->windupReq = false;
+        }
+
+        if (en->shotReq) {
+            spawn_enemy_bullet(g, en->shotX, en->shotY, en->shotDx, en->shotDy, 470.0f, 10);
+            en->shotReq = false;
+        }
+
+        if (en->emitReq) emit_bursts(g, en);
+
+        en->tookBullet = false;
+        for (; c < end && c->type == CONTACT_ENEMY_PLAYER && c->a == i; c++) {
+            g->hit = true;
+            g->hitDmg = en->touchDmg;
+            en->alive = false;
+        }
+    }
+
+    // bullet hits in the order they happen along the tick. a bullet stops at
+    // the first enemy on its path that still takes one, an enemy that already
+    // took one lets it fly on to the next
+    for (; c < end; c++) {
+        Enemy* en = &g->enemies[c->a];
+        Bullet* b = &g->bullets[c->b];
+        if (en->tookBullet || !b->alive) continue;
+        en->tookBullet = true;
+
+        int dmg = 25;
+        b->alive = false;
+
+        en->hp -= dmg;
+        push_event(g, EVENT_ENEMY_HIT, c->a, en->gen, dmg, en->x + en->size * 0.5f, en->y);
+
+        if (en->hp <= 0) {
+            en->alive = false;
+            push_event(g, EVENT_ENEMY_KILLED, c->a, en->gen, en->type,
+                       en->x + en->size * 0.5f, en->y + en->size * 0.5f);
+        }
+    }
+}
+
+static void center_panel(SDL_Renderer* r, float w, float h, float viewW, float viewH)
+{
+    float x = (viewW - w) * 0.5f;
+    float y = (viewH - h) * 0.5f;
 
     SDL_SetRenderDrawColor(r, 0, 0, 0, 120);
     draw_rect(r, x + 6, y + 8, w, h);
@@ -384,9 +1196,9 @@ static void center_panel(SDL_Renderer* r, float w, float h, float worldW, float
     draw_frame(r, x, y, w, h);
 }
 
-static void hud(Game* g, SDL_Renderer* r)
+static void hud(const GameView* v, SDL_Renderer* r)
 {
-    float W = g->worldW;
+    float W = v->viewW;
 
     float panelW = 720.0f;
     float panelH = 64.0f;
@@ -410,7 +1222,7 @@ static void hud(Game* g, SDL_Renderer* r)
     SDL_SetRenderDrawColor(r, 30, 30, 34, 255);
     draw_rect(r, barX, barY, barW, barH);
 
-    float t = (g->p.hpMax > 0) ? ((float)g->p.hp / (float)g->p.hpMax) : 0.0f;
+    float t = (v->hpMax > 0) ? ((float)v->hp / (float)v->hpMax) : 0.0f;
     t = clampf(t, 0.0f, 1.0f);
 
     SDL_SetRenderDrawColor(r, 220, 80, 80, 255);
@@ -421,20 +1233,22 @@ static void hud(Game* g, SDL_Renderer* r)
     int rightTx = (int)(x + panelW - 300);
 
     SDL_SetRenderDrawColor(r, 235, 235, 235, 255);
-    SDL_RenderDebugTextFormat(r, leftTx, (int)(y + 6), "HP %d/%d", g->p.hp, g->p.hpMax);
-    SDL_RenderDebugTextFormat(r, midTx, (int)(y + 6), "KILLS %d", g->kills);
+    SDL_RenderDebugTextFormat(r, leftTx, (int)(y + 6), "HP %d/%d", v->hp, v->hpMax);
+    SDL_RenderDebugTextFormat(r, midTx, (int)(y + 6), "KILLS %d", v->kills);
+    if (v->mode == MODE_STRESS)
+        SDL_RenderDebugTextFormat(r, midTx, (int)(y + 22), "BULLETS %d", v->ebCount);
 
-    if (g->p.reloading) {
+    if (v->reloading) {
         SDL_RenderDebugText(r, rightTx, (int)(y + 6), "RELOADING...");
     }
-    else if (g->p.reserve < 0) {
-        SDL_RenderDebugTextFormat(r, rightTx, (int)(y + 6), "AMMO %d/INF", g->p.mag);
+    else if (v->reserve < 0) {
+        SDL_RenderDebugTextFormat(r, rightTx, (int)(y + 6), "AMMO %d/INF", v->mag);
     }
     else {
-        SDL_RenderDebugTextFormat(r, rightTx, (int)(y + 6), "AMMO %d/%d", g->p.mag, g->p.reserve);
+        SDL_RenderDebugTextFormat(r, rightTx, (int)(y + 6), "AMMO %d/%d", v->mag, v->reserve);
     }
 
-    if (g->p.reloading) {
+    if (v->reloading) {
         float rx = x + panelW - 210.0f;
         float ry = y + 40.0f;
         float rw = 180.0f;
@@ -446,8 +1260,7 @@ static void hud(Game* g, SDL_Renderer* r)
         SDL_SetRenderDrawColor(r, 30, 30, 34, 255);
         draw_rect(r, rx, ry, rw, rh);
 
-        float rt = 1.0f - (g->p.reloadTimer / g->p.reloadTime);
-        rt = clampf(rt, 0.0f, 1.0f);
+        float rt = v->reloadT;
 
         SDL_SetRenderDrawColor(r, 240, 240, 240, 255);
         draw_rect(r, rx, ry, rw * rt, rh);
@@ -493,6 +1306,11 @@ void Game_HandleEvent(Game* g, const SDL_Event* e)
         }
     }
     else if (e->type == SDL_EVENT_KEY_DOWN) {
+        if (e->key.scancode == SDL_SCANCODE_TAB) {
+            g->board = (ScoreWindow)((g->board + 1) % BOARD_COUNT);
+            return;
+        }
+
         if (g->nameLocked) return;
         if (e->key.scancode == SDL_SCANCODE_BACKSPACE) {
             if (g->nameLen > 0) {
@@ -513,15 +1331,23 @@ void Game_HandleEvent(Game* g, const SDL_Event* e)
 void Game_Init(Game* g, float worldW, float worldH)
 {
     *g = (Game){ 0 };
+    Events_Init(&g->events);
+    Events_Attach(&g->events, &g->eventsGame);
     g->worldW = worldW;
     g->worldH = worldH;
+    g->viewW = worldW;
+    g->viewH = worldH;
+    update_area(g);
     g->state = GAME_MENU;
 
     SDL_strlcpy(g->playerName, "PLAYER", NAME_MAX);
     g->nameLen = (int)strlen(g->playerName);
     g->nameLocked = false;
 
-    load_scores(g);
+    if (!Scores_Load(SCORE_FILE, &g->score, Scores_Today()))
+        SDL_Log("can't read %s, boards start empty until the next save", SCORE_FILE);
+    g->board = BOARD_ALL;
+    ScoreSync_Start(&g->scoreSync, SCORE_FILE);
     g->lastRunKills = 0;
 
     g->p = (Player){
@@ -540,24 +1366,206 @@ void Game_Init(Game* g, float worldW, float worldH)
         .fireCooldown = 0.10f,
         .fireTimer = 0.0f,
         .reloadTime = 0.55f,
-        .reloadTimer = 0.0f,
         .reloading = false,
         .iFrameTime = 0.35f,
-        .iFrameTimer = 0.0f
+        .iFrames = false
     };
 
+    // no file = open arena
+    Tiles_Load(&g->tiles, ARENA_FILE, TILE_SIZE, worldW, worldH);
+
+    Game_Reserve(g, MAX_ENEMIES, MAX_BULLETS, MAX_EBULLETS);
+    g->jobs = Jobs_Create(0);
+    Kernels_Select(&g->kern, KERNEL_AVX2, true);
+
     reset_run(g);
 
     //SDL_StartTextInput();
     g->state = GAME_MENU;
 }
 
-void Game_Update(Game* g, const bool* keys, float dt)
+void Game_Shutdown(Game* g)
+{
+    // flushes any score still waiting for the writer
+    ScoreSync_Stop(&g->scoreSync);
+
+    Jobs_Destroy(g->jobs);
+    g->jobs = NULL;
+
+    Contacts_Free(&g->contacts);
+    for (int i = 0; i < PAR_CHUNKS; i++) Contacts_Free(&g->chunkContacts[i]);
+    Contacts_FreeBatch(&g->batch);
+    Grid_Free(&g->crowd);
+    Flow_Free(&g->flow);
+    Tiles_Free(&g->tiles);
+    Timers_Free(&g->timers);
+    if (g->stream) {
+        Stream_Close(g->stream);
+        SDL_free(g->stream);
+        g->stream = NULL;
+    }
+
+    SDL_free(g->enemies);
+    SDL_free(g->bullets);
+    free_ebullets(&g->eb);
+    g->enemies = NULL;
+    g->bullets = NULL;
+    g->maxEnemies = g->maxBullets = 0;
+}
+
+// (re)sizes the entity pools, everything in them is dropped
+bool Game_Reserve(Game* g, int enemies, int bullets, int ebullets)
+{
+    // only ever grows, a bigger batch than the pools is harmless
+    if (!Contacts_ReserveBatch(&g->batch, bullets, enemies)) return false;
+
+    Enemy* e = (Enemy*)SDL_calloc((size_t)enemies, sizeof(Enemy));
+    Bullet* b = (Bullet*)SDL_calloc((size_t)bullets, sizeof(Bullet));
+    EBulletPool eb;
+    bool ebOk = alloc_ebullets(&eb, ebullets);
+    if (!e || !b || !ebOk) {
+        SDL_free(e);
+        SDL_free(b);
+        if (ebOk) free_ebullets(&eb);
+        return false;
+    }
+
+    SDL_free(g->enemies);
+    SDL_free(g->bullets);
+    free_ebullets(&g->eb);
+
+    g->enemies = e;
+    g->bullets = b;
+    g->eb = eb;
+    g->maxEnemies = enemies;
+    g->maxBullets = bullets;
+    return true;
+}
+
+// stress mode swaps in the big pools, both start a fresh run
+void Game_SetMode(Game* g, GameMode mode)
+{
+    g->mode = mode;
+    if (mode == MODE_STRESS) Game_Reserve(g, STRESS_ENEMIES, STRESS_BULLETS, STRESS_EBULLETS);
+    else                     Game_Reserve(g, MAX_ENEMIES, MAX_BULLETS, MAX_EBULLETS);
+    reset_run(g);
+}
+
+void Game_SetView(Game* g, float w, float h)
+{
+    g->viewW = SDL_min(w, g->worldW);
+    g->viewH = SDL_min(h, g->worldH);
+    update_camera(g);
+    if (g->stream) warm_stream(g);
+}
+
+bool Game_OpenWorld(Game* g, const char* path)
 {
+    WorldStream* s = (WorldStream*)SDL_malloc(sizeof(WorldStream));
+    if (!s) return false;
+    // flow cells read the tiles as they are, the file has to use the same grid
+    if (!Stream_Open(s, path) || s->tile != TILE_SIZE) {
+        Stream_Close(s);
+        SDL_free(s);
+        return false;
+    }
+
+    if (g->stream) {
+        Stream_Close(g->stream);
+        SDL_free(g->stream);
+    }
+    Tiles_Free(&g->tiles);
+    // the window can come back in the same buffer at the same origin
+    Flow_Reset(&g->flow);
+    g->stream = s;
+    g->worldW = s->chunkPx * (float)s->chunksX;
+    g->worldH = s->chunkPx * (float)s->chunksY;
+    g->viewW = SDL_min(g->viewW, g->worldW);
+    g->viewH = SDL_min(g->viewH, g->worldH);
+    reset_run(g);
+    return true;
+}
+
+// a wheel timer went off, serially at the start of the tick before anything moves
+static void on_timer(void* ctx, const Timer* t)
+{
+    Game* g = (Game*)ctx;
+    Player* p = &g->p;
+
+    switch (t->kind) {
+    case TIMER_IFRAMES:
+        p->iFrames = false;
+        return;
+    case TIMER_RELOAD:
+        p->reloading = false;
+        do_reload(g);
+        return;
+    case TIMER_DASH_END:
+        p->dashing = false;
+        schedule(g, TIMER_DASH_READY, 0, 0, p->dashCooldown);
+        return;
+    case TIMER_DASH_READY:
+        p->dashReady = true;
+        return;
+    default:
+        break;
+    }
+
+    // the rest are an enemy's, dead or respawned since = not anymore
+    if (t->id >= (Uint32)g->maxEnemies) return;
+    Enemy* en = &g->enemies[t->id];
+    if (!en->alive || en->gen != t->gen) return;
+
+    switch (t->kind) {
+    case TIMER_SHOOT:
+        en->shootReady = true;
+        break;
+    case TIMER_WINDUP: {
+        // at the player as it stands, the pool is resolve's to touch
+        float ecx = en->x + en->size * 0.5f;
+        float ecy = en->y + en->size * 0.5f;
+        float toPx = p->x + p->size * 0.5f - ecx;
+        float toPy = p->y + p->size * 0.5f - ecy;
+        float dist = SDL_sqrtf(toPx * toPx + toPy * toPy);
+        en->shotReq = true;
+        en->shotX = ecx;
+        en->shotY = ecy;
+        en->shotDx = (dist > 0.0f) ? toPx / dist : 0.0f;
+        en->shotDy = (dist > 0.0f) ? toPy / dist : 0.0f;
+        en->windup = false;
+        schedule(g, TIMER_SHOOT, t->id, en->gen, en->shootCooldown);
+        break;
+    }
+    case TIMER_STRAFE:
+        en->strafeDir = -en->strafeDir;
+        schedule(g, TIMER_STRAFE, t->id, en->gen, strafe_time(en));
+        break;
+    case TIMER_EMIT:
+        // bursts only get counted, resolve fires them. the next one is off
+        // this one's due time so the rate holds at any tick length
+        if (en->emitReq < STRESS_MAX_BURSTS) en->emitReq++;
+        Timers_Add(&g->timers, t->due + (Uint64)(en->emitInterval * 1000.0f + 0.5f),
+                   TIMER_EMIT, t->id, en->gen);
+        break;
+    default:
+        break;
+    }
+}
+
+void Game_Update(Game* g, const GameInput* in, float dt)
+{
+    const bool* keys = in->keys;
     bool enterNow = keys[SDL_SCANCODE_RETURN] || keys[SDL_SCANCODE_KP_ENTER];
     bool rNow = keys[SDL_SCANCODE_R];
 
+    // board as our own last save left it, other processes' scores only come
+    // in with the reread that save does
+    ScoreSync_Poll(&g->scoreSync, &g->score);
+
     if (g->state == GAME_MENU) {
+        // rolls today/week over if the cabinet sits in the menu past midnight
+        Scores_Advance(&g->score, Scores_Today());
+
         if (pressed(enterNow, &g->prevEnter)) {
             g->nameLocked = true;
 
@@ -586,21 +1594,16 @@ void Game_Update(Game* g, const bool* keys, float dt)
 
     Player* p = &g->p;
 
-    if (p->iFrameTimer > 0.0f) p->iFrameTimer -= dt;
-    if (p->fireTimer > 0.0f) p->fireTimer -= dt;
+    // everything due by the end of this tick goes off first
+    g->clock += (double)dt;
+    Timers_Advance(&g->timers, clock_ms(g->clock), on_timer, g);
+
+    // runs negative when a shot comes due inside this tick, see the fire loop
+    p->fireTimer -= dt;
 
     if (pressed(rNow, &g->prevR)) start_reload(g);
     else g->prevR = rNow;
 
-    if (p->reloading) {
-        p->reloadTimer -= dt;
-        if (p->reloadTimer <= 0.0f) {
-            p->reloading = false;
-            p->reloadTimer = 0.0f;
-            do_reload(g);
-        }
-    }
-
     p->dx = p->dy = 0.0f;
     if (keys[SDL_SCANCODE_W]) p->dy -= 1.0f;
     if (keys[SDL_SCANCODE_S]) p->dy += 1.0f;
@@ -608,33 +1611,32 @@ void Game_Update(Game* g, const bool* keys, float dt)
     if (keys[SDL_SCANCODE_D]) p->dx += 1.0f;
 
     bool spaceNow = keys[SDL_SCANCODE_SPACE];
-    if (!p->dashing && p->cooldownTimer <= 0.0f &&
+    if (!p->dashing && p->dashReady &&
         spaceNow && (p->dx != 0.0f || p->dy != 0.0f)) {
         p->dashing = true;
-        p->dashTimer = p->dashTime;
-        p->cooldownTimer = p->dashCooldown;
+        p->dashReady = false;
+        schedule(g, TIMER_DASH_END, 0, 0, p->dashTime);
     }
 
     float len = SDL_sqrtf(p->dx * p->dx + p->dy * p->dy);
     if (len > 0.0f) { p->dx /= len; p->dy /= len; }
 
-    float moveSpeed = p->dashing ? p->dashSpeed : p->speed;
-    p->x += p->dx * moveSpeed * dt;
-    p->y += p->dy * moveSpeed * dt;
+    p->px = p->x;
+    p->py = p->y;
 
-    if (p->dashing) {
-        p->dashTimer -= dt;
-        if (p->dashTimer <= 0.0f) p->dashing = false;
-    }
-    else if (p->cooldownTimer > 0.0f) {
-        p->cooldownTimer -= dt;
-    }
+    // swept through the walls, a dash stops at the first one it meets
+    float moveSpeed = p->dashing ? p->dashSpeed : p->speed;
+    Tiles_Move(&g->tiles, &p->x, &p->y, p->size, p->size,
+               p->dx * moveSpeed * dt, p->dy * moveSpeed * dt);
 
     p->x = clampf(p->x, 0.0f, g->worldW - p->size);
     p->y = clampf(p->y, 0.0f, g->worldH - p->size);
+    update_camera(g);
+    if (g->stream) update_stream(g);
 
-    float mx, my;
-    SDL_GetMouseState(&mx, &my);
+    // mouse is in screen space
+    float mx = in->mouseX + g->camX;
+    float my = in->mouseY + g->camY;
 
     float pcx = p->x + p->size * 0.5f;
     float pcy = p->y + p->size * 0.5f;
@@ -644,362 +1646,370 @@ void Game_Update(Game* g, const bool* keys, float dt)
     float alen = SDL_sqrtf(aimx * aimx + aimy * aimy);
     if (alen > 0.0f) { aimx /= alen; aimy /= alen; }
 
-    Uint32 mb = SDL_GetMouseState(NULL, NULL);
-    bool shootNow = (mb & SDL_BUTTON_LMASK) || keys[SDL_SCANCODE_LCTRL];
-    if (shootNow && p->fireTimer <= 0.0f && alen > 0.0f) {
-        fire_bullet(g, aimx, aimy);
+    bool shootNow = (in->mouse & SDL_BUTTON_LMASK) || keys[SDL_SCANCODE_LCTRL];
+    if (shootNow && alen > 0.0f) {
+        // every shot due inside the tick, at its own time and origin,
+        // so the fire rate is exactly fireCooldown at any tick rate
+        while (p->fireTimer <= 0.0f) {
+            float age = -p->fireTimer;
+            if (age > dt) age = dt;
+
+            float t = (dt > 0.0f) ? age / dt : 0.0f;
+            float ox = pcx + (p->px - p->x) * t;
+            float oy = pcy + (p->py - p->y) * t;
+
+            if (!fire_bullet(g, ox, oy, aimx, aimy, age)) break;
+            p->fireTimer += p->fireCooldown;
+        }
     }
+    // an idle (or empty) trigger doesn't bank shots
+    if (p->fireTimer < 0.0f) p->fireTimer = 0.0f;
 
     g->spawnTimer -= dt;
     if (g->spawnTimer <= 0.0f) spawn_enemy(g);
+    if (g->stream) tick_spawners(g, dt);
 
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        Bullet* b = &g->bullets[i];
-        if (!b->alive) continue;
-
-        b->x += b->vx * dt;
-        b->y += b->vy * dt;
+    PassCtx pass = {
+        .g = g, .dt = dt, .pcx = pcx, .pcy = pcy,
+        .nearX0 = g->camX - LOD_MARGIN, .nearY0 = g->camY - LOD_MARGIN,
+        .nearX1 = g->camX + g->viewW + LOD_MARGIN, .nearY1 = g->camY + g->viewH + LOD_MARGIN
+    };
 
-        if (b->x < -50 || b->x > g->worldW + 50 || b->y < -50 || b->y > g->worldH + 50)
-            b->alive = false;
+    run_pass(g, &pass, g->maxBullets, 1, job_bullets);
+    run_pass(g, &pass, g->eb.count, 1, job_ebullets);
+
+    // move pass, enemies only write to themselves and read the others
+    // through the grid, which holds where everyone started the tick
+    // sight checks against the walls, an open arena never blocks one
+    if (g->tiles.solid) run_pass(g, &pass, g->maxEnemies, 8, job_archer_los);
+    // a world bigger than the screen only searches around the view
+    float reach = (g->viewW < g->worldW || g->viewH < g->worldH) ? g->viewW + g->viewH + 2.0f * LOD_MARGIN : 0.0f;
+    pass.flow = Flow_Update(&g->flow, FLOW_CELL, g->areaX, g->areaY, g->areaW, g->areaH,
+                            g->tiles.solid, reach, pcx, pcy);
+    pass.crowd = index_enemies(g);
+    pass.aiPeriod = ai_period(g->aiFar);
+    pass.aiTick = g->aiTick++;
+    run_pass(g, &pass, g->maxEnemies, 32, job_move_enemies);
+    g->aiFar = 0;
+    for (int k = 0; k < pass.chunks; k++) g->aiFar += pass.far[k];
+
+    // detect pass, read only, per-chunk lists joined in chunk order
+    Contacts_Pack(g);
+    g->contacts.count = 0;
+    run_pass(g, &pass, g->eb.count, 1, job_detect_ebullets);
+    join_contacts(g, &pass);
+    run_pass(g, &pass, g->maxEnemies, g->maxBullets, job_detect_enemies);
+    join_contacts(g, &pass);
+
+    // resolve pass, serial and in a fixed order
+    resolve_contacts(g);
+    compact_ebullets(&g->eb);
+
+    g->damageTick -= dt;
+
+    if (g->hit && g->damageTick <= 0.0f) {
+        g->damageTick = 0.25f;
+
+        if (player_can_take_damage(g)) damage_player(g, g->hitDmg);
     }
 
-    for (int i = 0; i < MAX_EBULLETS; i++) {
-        EnemyBullet* b = &g->ebullets[i];
-        if (!b->alive) continue;
-
-        b->x += b->vx * dt;
-        b->y += b->vy * dt;
-
-        if (b->x > p->x && b->x < p->x + p->size &&
-            b->y > p->y && b->y < p->y + p->size)
-        {
-            if (player_can_take_damage(g)) {
-                int dmg = b->dmg;
-                p->hp -= dmg;
-
-                p->iFrameTimer = p->iFrameTime;
-                g->timeSinceHit = 0.0f;
-                g->regenAcc = 0.0f;
-
-                spawn_dmg(g, p->x + p->size * 0.5f, p->y - 6.0f, -dmg);
-
-                if (p->hp <= 0) {
-                    p->hp = 0;
-                    g->state = GAME_DEAD;
-
-                    // submit score on d
-                    g->lastRunKills = g->kills;
-                    submit_score(g, g->playerName, g->kills);
-                }
-            }
-
-            b->alive = false;
-            continue;
+    g->timeSinceHit += dt;
+    if (g->timeSinceHit >= g->regenDelay && p->hp > 0 && p->hp < p->hpMax) {
+        g->regenAcc += g->regenRate * dt;
+        int add = (int)g->regenAcc;
+        if (add > 0) {
+            p->hp += add;
+            if (p->hp > p->hpMax) p->hp = p->hpMax;
+            g->regenAcc -= (float)add;
         }
-
-        if (b->x < -60 || b->x > g->worldW + 60 || b->y < -60 || b->y > g->worldH + 60)
-            b->alive = false;
     }
 
-    g->hit = false;
-    g->hitDmg = 14;
-
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        Enemy* en = &g->enemies[i];
-        if (!en->alive) continue;
-
-        if (en->type == ENEMY_ARCHER) {
-            float ecx = en->x + en->size * 0.5f;
-            float ecy = en->y + en->size * 0.5f;
-
-            float toPx = pcx - ecx;
-            float toPy = pcy - ecy;
-            float dist = SDL_sqrtf(toPx * toPx + toPy * toPy);
-            float nx = 0.0f, ny = 0.0f;
-            if (dist > 0.0f) { nx = toPx / dist; ny = toPy / dist; }
-
-            en->strafeTimer -= dt;
-            if (en->strafeTimer <= 0.0f) {
-                en->strafeDir = -en->strafeDir;
-                en->strafeTimer = 0.6f + (rand() % 60) / 100.0f;
-            }
-
-            float desired = 240.0f;
-            float moveX = 0.0f, moveY = 0.0f;
-
-            if (dist < desired - 30.0f) {
-                moveX -= nx; moveY -= ny;
-            }
-            else if (dist > desired + 60.0f) {
-                moveX += nx * 0.55f; moveY += ny * 0.55f;
-            }
-
-            float pxp = -ny;
-            float pyp = nx;
-            moveX += pxp * en->strafeDir * 0.75f;
-            moveY += pyp * en->strafeDir * 0.75f;
-
-            float ml = SDL_sqrtf(moveX * moveX + moveY * moveY);
-            if (ml > 0.0f) { moveX /= ml; moveY /= ml; }
+    // side effects of the step, batched per consumer
+    dispatch_events(g);
+    expire_dmg_nums(g);
+}
 
-            en->x += moveX * en->speed * dt;
-            en->y += moveY * en->speed * dt;
+/* ------------------ render snapshot ------------------ */
 
-            en->x = clampf(en->x, 0.0f, g->worldW - en->size);
-            en->y = clampf(en->y, 0.0f, g->worldH - en->size);
+static bool same_color(SDL_Color a, SDL_Color b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
 
-            if (en->windup > 0.0f) {
-                en->windup -= dt;
-                if (en->windup <= 0.0f) {
-                    spawn_enemy_bullet(g, ecx, ecy, nx, ny, 10);
-                    en->shootTimer = en->shootCooldown;
-                }
-            }
-            else {
-                en->shootTimer -= dt;
-                if (en->shootTimer <= 0.0f) {
-                    float s = difficulty_scale(g->kills);
-                    en->windup = 0.22f - 0.06f * (s - 1.0f);
-                    if (en->windup < 0.14f) en->windup = 0.14f;
-                }
-            }
+// appends a rect, a new run starts whenever the color changes
+static void view_rect(GameView* v, float x, float y, float w, float h, SDL_Color c)
+{
+    if (v->rectCount == v->rectCap) {
+        int cap = v->rectCap ? v->rectCap * 2 : 256;
+        SDL_FRect* rects = (SDL_FRect*)SDL_realloc(v->rects, (size_t)cap * sizeof(SDL_FRect));
+        if (!rects) return;
+        v->rects = rects;
+        v->rectCap = cap;
+    }
 
-            bool overlap =
-                en->x < p->x + p->size &&
-                en->x + en->size > p->x &&
-                en->y < p->y + p->size &&
-                en->y + en->size > p->y;
+    ViewRun* run = v->runCount ? &v->runs[v->runCount - 1] : NULL;
+    if (!run || !same_color(run->color, c)) {
+        if (v->runCount == v->runCap) {
+            int cap = v->runCap ? v->runCap * 2 : 64;
+            ViewRun* runs = (ViewRun*)SDL_realloc(v->runs, (size_t)cap * sizeof(ViewRun));
+            if (!runs) return;
+            v->runs = runs;
+            v->runCap = cap;
+        }
+        run = &v->runs[v->runCount++];
+        run->color = c;
+        run->first = v->rectCount;
+        run->count = 0;
+    }
 
-            if (overlap) {
-                g->hit = true;
-                g->hitDmg = en->touchDmg;
-                en->alive = false;
-            }
+    v->rects[v->rectCount++] = (SDL_FRect){ x, y, w, h };
+    run->count++;
+}
 
-            for (int bi = 0; bi < MAX_BULLETS; bi++) {
-                Bullet* b = &g->bullets[bi];
-                if (!b->alive) continue;
+static SDL_Color enemy_color(const Enemy* e)
+{
+    // winding up a shot
+    if (e->windup) return (SDL_Color){ 190, 255, 190, 255 };
+    return ARCHETYPES[e->type].color;
+}
 
-                if (b->x > en->x && b->x < en->x + en->size &&
-                    b->y > en->y && b->y < en->y + en->size) {
+static void snap_enemy(GameView* v, const Enemy* e, float ox, float oy, float x1, float y1)
+{
+    if (!e->alive || e->x + e->size < ox || e->x > x1 || e->y + e->size < oy || e->y > y1) return;
+    view_rect(v, e->x - ox, e->y - oy, e->size, e->size, enemy_color(e));
+}
 
-                    int dmg = 25;
-                    b->alive = false;
+void Game_Snapshot(const Game* g, GameView* v)
+{
+    v->state = g->state;
+    v->mode = g->mode;
+    v->viewW = g->viewW;
+    v->viewH = g->viewH;
+
+    v->rectCount = 0;
+    v->runCount = 0;
+    v->numCount = 0;
+
+    v->hp = g->p.hp;
+    v->hpMax = g->p.hpMax;
+    v->kills = g->kills;
+    v->mag = g->p.mag;
+    v->reserve = g->p.reserve;
+    v->reloading = g->p.reloading;
+    float left = g->p.reloading ? (float)(g->p.reloadDone - g->clock) : 0.0f;
+    v->reloadT = clampf(1.0f - (left / g->p.reloadTime), 0.0f, 1.0f);
+    v->ebCount = g->eb.count;
+
+    SDL_strlcpy(v->playerName, g->playerName, NAME_MAX);
+    v->nameLocked = g->nameLocked;
+    v->lastRunKills = g->lastRunKills;
+    v->yourBest = best_for_name(&g->score.boards[BOARD_ALL], g->playerName);
+
+    const ScoreBoard* board = &g->score.boards[g->board];
+    v->board = g->board;
+    v->topCount = (board->count < LEADER_TOP) ? board->count : LEADER_TOP;
+    SDL_memcpy(v->top, board->top, (size_t)v->topCount * sizeof(ScoreEntry));
+
+    int boardBest = best_for_name(board, g->playerName);
+    v->boardRank = 0;
+    v->boardRuns = board->hist.total;
+    if (board->hist.total > 0 && boardBest > 0) {
+        v->boardRank = ScoreHist_Rank(&board->hist, boardBest);
+        v->boardPct = ScoreHist_TopPercent(&board->hist, boardBest);
+    }
 
-                    en->hp -= dmg;
-                    spawn_dmg(g, en->x + en->size * 0.5f, en->y, dmg);
+    const ScoreHist* hist = &g->score.boards[BOARD_ALL].hist;
+    v->deathRuns = hist->total;
+    if (hist->total > 0) {
+        v->deathRank = ScoreHist_Rank(hist, g->kills);
+        v->deathPct = ScoreHist_TopPercent(hist, g->kills);
+    }
 
-                    if (en->hp <= 0) {
-                        en->alive = false;
-                        g->kills++;
-                    }
-                    break;
-                }
+    // menu draws no world
+    if (g->state == GAME_MENU) return;
+
+    // everything below is culled to the camera and moved to screen space
+    float ox = g->camX, oy = g->camY;
+    float x1 = ox + g->viewW, y1 = oy + g->viewH;
+
+    // walls first, one rect per horizontal run of tiles on screen
+    const TileMap* t = &g->tiles;
+    if (t->solid) {
+        float lx = ox - t->ox, ly = oy - t->oy;
+        int c0 = SDL_max((int)(lx / t->tile), 0), c1 = SDL_min((int)((x1 - t->ox) / t->tile), t->cols - 1);
+        int r0 = SDL_max((int)(ly / t->tile), 0), r1 = SDL_min((int)((y1 - t->oy) / t->tile), t->rows - 1);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; ) {
+                if (!t->solid[r * t->cols + c]) { c++; continue; }
+                int cs = c;
+                while (c <= c1 && t->solid[r * t->cols + c]) c++;
+                view_rect(v, cs * t->tile - lx, r * t->tile - ly, (c - cs) * t->tile, t->tile,
+                          (SDL_Color){ 70, 70, 82, 255 });
             }
-
-            continue;
-        }
-
-        float ex = en->x - p->x;
-        float ey = en->y - p->y;
-        float d = SDL_sqrtf(ex * ex + ey * ey);
-        if (d > 0.0f) { ex /= d; ey /= d; }
-
-        en->x -= ex * en->speed * dt;
-        en->y -= ey * en->speed * dt;
-
-        bool overlap =
-            en->x < p->x + p->size &&
-            en->x + en->size > p->x &&
-            en->y < p->y + p->size &&
-            en->y + en->size > p->y;
-
-        if (overlap) {
-            g->hit = true;
-            g->hitDmg = en->touchDmg;
-            en->alive = false;
         }
+    }
 
-        for (int bi = 0; bi < MAX_BULLETS; bi++) {
-            Bullet* b = &g->bullets[bi];
-            if (!b->alive) continue;
-
-            if (b->x > en->x && b->x < en->x + en->size &&
-                b->y > en->y && b->y < en->y + en->size) {
-
-                int dmg = 25;
-                b->alive = false;
-
-                en->hp -= dmg;
-                spawn_dmg(g, en->x + en->size * 0.5f, en->y, dmg);
-
-                if (en->hp <= 0) {
-                    en->alive = false;
-                    g->kills++;
+    // enemies through the crowd grid, only the cells under the view are read.
+    // it holds every enemy alive at the move pass, the margin covers one tick
+    // of movement. a view over most of the world just walks the array
+    const Grid* gr = &g->crowd;
+    if (gr->cols > 0 && g->viewW * g->viewH < 0.5f * g->worldW * g->worldH) {
+        int c0, r0, c1, r1;
+        Grid_Range(gr, ox - CROWD_CELL, oy - CROWD_CELL, x1 + CROWD_CELL, y1 + CROWD_CELL, &c0, &r0, &c1, &r1);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                int cell = r * gr->cols + c;
+                for (int k = gr->start[cell]; k < gr->start[cell + 1]; k++) {
+                    int i = gr->slot[k];
+                    if (i < g->maxEnemies) snap_enemy(v, &g->enemies[i], ox, oy, x1, y1);
                 }
-                break;
             }
         }
     }
+    else {
+        for (int i = 0; i < g->maxEnemies; i++) snap_enemy(v, &g->enemies[i], ox, oy, x1, y1);
+    }
 
-    static float damageTick = 0.0f;
-    damageTick -= dt;
-
-    if (g->hit && damageTick <= 0.0f) {
-        damageTick = 0.25f;
-
-        if (player_can_take_damage(g)) {
-            int dmg = g->hitDmg;
-            p->hp -= dmg;
-
-            p->iFrameTimer = p->iFrameTime;
-            g->timeSinceHit = 0.0f;
-            g->regenAcc = 0.0f;
-
-            spawn_dmg(g, p->x + p->size * 0.5f, p->y - 6.0f, -dmg);
-
-            if (p->hp <= 0) {
-                p->hp = 0;
-                g->state = GAME_DEAD;
+    for (int i = 0; i < g->maxBullets; i++) {
+        const Bullet* b = &g->bullets[i];
+        if (!b->alive || b->x < ox - 2 || b->x > x1 + 2 || b->y < oy - 2 || b->y > y1 + 2) continue;
+        view_rect(v, b->x - ox - 2, b->y - oy - 2, 4, 4, (SDL_Color){ 240, 240, 240, 255 });
+    }
 
-                g->lastRunKills = g->kills;
-                submit_score(g, g->playerName, g->kills);
-            }
-        }
+    const EBulletPool* eb = &g->eb;
+    for (int i = 0; i < eb->count; i++) {
+        float bx = eb->x[i], by = eb->y[i];
+        if (!eb->alive[i] || bx < ox - 2 || bx > x1 + 2 || by < oy - 2 || by > y1 + 2) continue;
+        view_rect(v, bx - ox - 2, by - oy - 2, 4, 4, (SDL_Color){ 170, 255, 170, 255 });
     }
 
-    g->timeSinceHit += dt;
-    if (g->timeSinceHit >= g->regenDelay && p->hp > 0 && p->hp < p->hpMax) {
-        g->regenAcc += g->regenRate * dt;
-        int add = (int)g->regenAcc;
-        if (add > 0) {
-            p->hp += add;
-            if (p->hp > p->hpMax) p->hp = p->hpMax;
-            g->regenAcc -= (float)add;
-        }
+    SDL_Color pc = { 80, 200, 255, 255 };
+    if (g->p.dashing) pc = (SDL_Color){ 255, 80, 80, 255 };
+    else if (g->p.iFrames) pc = (SDL_Color){ 180, 220, 255, 255 };
+    view_rect(v, g->p.x - ox, g->p.y - oy, g->p.size, g->p.size, pc);
+
+    // only what's on screen gets text drawn for it
+    Uint32 now = (Uint32)clock_ms(g->clock);
+    for (int i = 0; i < g->dmgCount; i++) {
+        const DamageNum* d = &g->dmgnums[i];
+        float x = d->x - ox;
+        float y = d->y - DMG_NUM_RISE * (float)(now - d->born) * 0.001f - oy;
+        if (x < -32.0f || x > g->viewW + 32.0f || y < -16.0f || y > g->viewH + 16.0f) continue;
+
+        ViewNum* n = &v->nums[v->numCount++];
+        n->x = x;
+        n->y = y;
+        n->value = d->value;
     }
+}
 
-    update_dmgnums(g, dt);
+void GameView_Free(GameView* v)
+{
+    SDL_free(v->rects);
+    SDL_free(v->runs);
+    v->rects = NULL;
+    v->runs = NULL;
+    v->rectCount = v->rectCap = 0;
+    v->runCount = v->runCap = 0;
 }
 
-void Game_Render(Game* g, SDL_Renderer* renderer)
+void Game_Render(const GameView* v, SDL_Renderer* renderer)
 {
     // MENU
-    if (g->state == GAME_MENU) {
+    if (v->state == GAME_MENU) {
         float pw = 600, ph = 380;
-        center_panel(renderer, pw, ph, g->worldW, g->worldH);
+        center_panel(renderer, pw, ph, v->viewW, v->viewH);
 
-        int cx = (int)(g->worldW * 0.5f);
-        int top = (int)(g->worldH * 0.5f - ph * 0.5f);
+        int cx = (int)(v->viewW * 0.5f);
+        int top = (int)(v->viewH * 0.5f - ph * 0.5f);
 
         SDL_SetRenderDrawColor(renderer, 245, 245, 245, 255);
-        dbg_center(renderer, cx, top + 55, "MARK");
+        dbg_center(renderer, cx, top + 55, (v->mode == MODE_STRESS) ? "MARK - STRESS" : "MARK");
 
         // name line
         SDL_SetRenderDrawColor(renderer, 220, 220, 220, 255);
 
         char nameLine[128];
-        if (!g->nameLocked) {
-            SDL_snprintf(nameLine, (int)sizeof(nameLine), "NAME: %s_", g->playerName);
+        if (!v->nameLocked) {
+            SDL_snprintf(nameLine, (int)sizeof(nameLine), "NAME: %s_", v->playerName);
         }
         else {
-            SDL_snprintf(nameLine, (int)sizeof(nameLine), "NAME: %s", g->playerName);
+            SDL_snprintf(nameLine, (int)sizeof(nameLine), "NAME: %s", v->playerName);
         }
         dbg_center(renderer, cx, top + 105, nameLine);
 
-        int yourBest = best_for_name(g, g->playerName);
-
         char stat1[128], stat2[128];
-        SDL_snprintf(stat1, (int)sizeof(stat1), "LAST RUN: %d", g->lastRunKills);
-        SDL_snprintf(stat2, (int)sizeof(stat2), "YOUR BEST: %d", yourBest);
+        SDL_snprintf(stat1, (int)sizeof(stat1), "LAST RUN: %d", v->lastRunKills);
+        SDL_snprintf(stat2, (int)sizeof(stat2), "YOUR BEST: %d", v->yourBest);
 
         dbg_center(renderer, cx, top + 135, stat1);
         dbg_center(renderer, cx, top + 160, stat2);
 
-        dbg_center(renderer, cx, top + 195, "LEADERBOARD (TOP 5)");
-        for (int i = 0; i < LEADER_TOP; i++) {
-            if (i >= g->scoreCount) break;
+        static const char* boardNames[BOARD_COUNT] = { "ALL TIME", "THIS WEEK", "TODAY" };
+
+        if (v->boardRank > 0) {
+            char stat3[128];
+            SDL_snprintf(stat3, (int)sizeof(stat3), "RANK #%d OF %d RUNS (TOP %d%%)",
+                v->boardRank, v->boardRuns, v->boardPct);
+            dbg_center(renderer, cx, top + 176, stat3);
+        }
+
+        char head[64];
+        SDL_snprintf(head, (int)sizeof(head), "< %s > (TOP %d)", boardNames[v->board], LEADER_TOP);
+        dbg_center(renderer, cx, top + 195, head);
+        for (int i = 0; i < v->topCount; i++) {
             char row[128];
             SDL_snprintf(row, (int)sizeof(row), "%d) %s  -  %d",
-                i + 1, g->scores[i].name, g->scores[i].bestKills);
+                i + 1, v->top[i].name, v->top[i].bestKills);
             dbg_center(renderer, cx, top + 220 + i * 18, row);
         }
 
         dbg_center(renderer, cx, top + 320, "ENTER: Start");
-        dbg_center(renderer, cx, top + 345, "Backspace: delete   Esc: clear");
+        dbg_center(renderer, cx, top + 345, "Backspace: delete   Esc: clear   Tab: board");
         return;
     }
 
-    // enemies
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        Enemy* e = &g->enemies[i];
-        if (!e->alive) continue;
-
-        if (e->type == ENEMY_RUNNER) SDL_SetRenderDrawColor(renderer, 240, 110, 110, 255);
-        else if (e->type == ENEMY_TANK) SDL_SetRenderDrawColor(renderer, 160, 50, 50, 255);
-        else if (e->type == ENEMY_ARCHER) SDL_SetRenderDrawColor(renderer, 140, 220, 140, 255);
-        else SDL_SetRenderDrawColor(renderer, 200, 60, 60, 255);
-
-        if (e->type == ENEMY_ARCHER && e->windup > 0.0f)
-            SDL_SetRenderDrawColor(renderer, 190, 255, 190, 255);
-
-        SDL_FRect er = { e->x, e->y, e->size, e->size };
-        SDL_RenderFillRect(renderer, &er);
-    }
-
-    SDL_SetRenderDrawColor(renderer, 240, 240, 240, 255);
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (!g->bullets[i].alive) continue;
-        SDL_FRect br = { g->bullets[i].x - 2, g->bullets[i].y - 2, 4, 4 };
-        SDL_RenderFillRect(renderer, &br);
+    // enemies, bullets, player, one call per color run
+    for (int i = 0; i < v->runCount; i++) {
+        const ViewRun* run = &v->runs[i];
+        SDL_SetRenderDrawColor(renderer, run->color.r, run->color.g, run->color.b, run->color.a);
+        SDL_RenderFillRects(renderer, v->rects + run->first, run->count);
     }
 
-    SDL_SetRenderDrawColor(renderer, 170, 255, 170, 255);
-    for (int i = 0; i < MAX_EBULLETS; i++) {
-        if (!g->ebullets[i].alive) continue;
-        SDL_FRect br = { g->ebullets[i].x - 2, g->ebullets[i].y - 2, 4, 4 };
-        SDL_RenderFillRect(renderer, &br);
-    }
-
-    if (g->p.dashing) SDL_SetRenderDrawColor(renderer, 255, 80, 80, 255);
-    else if (g->p.iFrameTimer > 0.0f) SDL_SetRenderDrawColor(renderer, 180, 220, 255, 255);
-    else SDL_SetRenderDrawColor(renderer, 80, 200, 255, 255);
-
-    SDL_FRect pr = { g->p.x, g->p.y, g->p.size, g->p.size };
-    SDL_RenderFillRect(renderer, &pr);
-
-    for (int i = 0; i < MAX_DMG_NUMS; i++) {
-        if (!g->dmgnums[i].alive) continue;
+    for (int i = 0; i < v->numCount; i++) {
+        const ViewNum* n = &v->nums[i];
 
-        if (g->dmgnums[i].value < 0) SDL_SetRenderDrawColor(renderer, 255, 120, 120, 255);
-        else                         SDL_SetRenderDrawColor(renderer, 240, 240, 240, 255);
+        if (n->value < 0) SDL_SetRenderDrawColor(renderer, 255, 120, 120, 255);
+        else              SDL_SetRenderDrawColor(renderer, 240, 240, 240, 255);
 
         char buf[32];
-        SDL_snprintf(buf, (int)sizeof(buf), "%d", g->dmgnums[i].value);
+        SDL_snprintf(buf, (int)sizeof(buf), "%d", n->value);
         int w = (int)strlen(buf) * 8;
 
-        SDL_RenderDebugText(renderer,
-            (int)g->dmgnums[i].x - w / 2,
-            (int)g->dmgnums[i].y,
-            buf
-        );
+        SDL_RenderDebugText(renderer, (int)n->x - w / 2, (int)n->y, buf);
     }
 
-    hud(g, renderer);
+    hud(v, renderer);
 
-    if (g->state == GAME_DEAD) {
+    if (v->state == GAME_DEAD) {
         float pw = 560, ph = 240;
-        center_panel(renderer, pw, ph, g->worldW, g->worldH);
+        center_panel(renderer, pw, ph, v->viewW, v->viewH);
 
-        int cx = (int)(g->worldW * 0.5f);
-        int top = (int)(g->worldH * 0.5f - ph * 0.5f);
+        int cx = (int)(v->viewW * 0.5f);
+        int top = (int)(v->viewH * 0.5f - ph * 0.5f);
 
         SDL_SetRenderDrawColor(renderer, 245, 245, 245, 255);
         dbg_center(renderer, cx, top + 60, "YOU DIED");
 
         SDL_SetRenderDrawColor(renderer, 220, 220, 220, 255);
-        dbg_centerf(renderer, cx, top + 105, "Kills: %d", g->kills);
+        dbg_centerf(renderer, cx, top + 105, "Kills: %d", v->kills);
+
+        if (v->deathRuns > 0) {
+            char rank[128];
+            SDL_snprintf(rank, (int)sizeof(rank), "Run #%d of %d (top %d%%)",
+                v->deathRank, v->deathRuns, v->deathPct);
+            dbg_center(renderer, cx, top + 125, rank);
+        }
         dbg_center(renderer, cx, top + 155, "Press ENTER to return to menu");
     }
 }
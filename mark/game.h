@@ -2,78 +2,179 @@
 #include <SDL3/SDL.h>
 #include <stdbool.h>
 
+#include "scores.h"
+#include "collide.h"
+#include "jobs.h"
+#include "kernels.h"
+#include "grid.h"
+#include "flow.h"
+#include "tiles.h"
+#include "stream.h"
+#include "timers.h"
+#include "events.h"
+
+// default pool sizes, Game_Reserve can grow them (stress/bench scenes)
 #define MAX_ENEMIES   32
 #define MAX_BULLETS   128
 #define MAX_DMG_NUMS  64
 #define MAX_EBULLETS  128
 
-#define NAME_MAX      16
-#define SCORE_MAX     32
+// passes with less work than this (slots * per-slot weight) stay on the
+// calling thread, waking the pool costs more than it saves
+#define PAR_MIN_WORK  32768
+#define PAR_CHUNKS    64
+
+// enemies per move batch, one per move kind lives on a worker's stack.
+// also the most one chase kernel call gets
+#define MOVE_BLOCK    256
+
+// crowd separation grid: cell >= the biggest separation radius, so a
+// neighbour query is at most a 3x3 block. both caps keep a pile-up O(n)
+#define CROWD_CELL          64.0f
+#define CROWD_MAX_NEIGHBORS 12
+#define CROWD_MAX_SCAN      48
+
+// arena walls, one map tile
+#define TILE_SIZE           32.0f
+
+// sim LOD: enemies this far outside the camera skip separation and
+// archers there don't shoot (they walk in instead)
+#define LOD_MARGIN          200.0f
+
+// AI LOD: enemies outside the near rect think every AI_FAR_TICKS ticks,
+// staggered by slot, on the time they banked meanwhile. more than
+// AI_FAR_BUDGET due in one tick stretches the interval instead
+#define AI_FAR_TICKS        4
+#define AI_FAR_BUDGET       1024
+
+// archers re-check line of sight every LOS_TICKS ticks, LOS_BLOCK per batch query
+#define LOS_TICKS           6
+#define LOS_BLOCK           256
+
+// flow field cell, rebuilt each time the player crosses into another one.
+// same grid as the tiles so it reads the walls as they are
+#define FLOW_CELL           TILE_SIZE
+
+// streamed worlds: chunk spawners only fire this far outside the view
+#define SPAWNER_MARGIN      64.0f
+
 #define LEADER_TOP    5
 
+// bullet-hell stress mode, emitters keep ~50k enemy bullets in the air
+#define STRESS_ENEMIES   256
+#define STRESS_BULLETS   512
+#define STRESS_EBULLETS  65536
+#define STRESS_DMG       4
+#define STRESS_MAX_BURSTS 8     // per emitter per tick, after a long stall
+
 typedef enum {
     GAME_MENU = 0,
     GAME_PLAY = 1,
     GAME_DEAD = 2,
 } GameState;
 
+typedef enum {
+    MODE_ARCADE = 0,
+    MODE_STRESS = 1,
+} GameMode;
+
+typedef enum {
+    EMIT_NONE = 0,
+    EMIT_RADIAL = 1,    // full ring every burst, ring offset turns a bit
+    EMIT_SPIRAL = 2,    // few arms, fast bursts, turns every burst
+} EmitKind;
+
 typedef enum {
     ENEMY_GRUNT = 0,
     ENEMY_RUNNER = 1,
     ENEMY_TANK = 2,
     ENEMY_ARCHER = 3,
+    ENEMY_TYPE_COUNT
 } EnemyType;
 
 typedef struct {
     float x, y;
+    float px, py;   // position at the start of the tick (swept tests)
     float size;
     float speed;
     bool alive;
+    Uint32 gen;     // bumped per spawn, timers of an earlier life see it changed
 
     EnemyType type;
     int hp;
     int touchDmg;
 
-    // archer logic
+    // archer logic, the timers live on the game's wheel
     float shootCooldown;
-    float shootTimer;
+    bool shootReady;    // cooldown ran out, shoots once the player is in sight
+    bool windup;        // winding up a shot
     float strafeDir;
-    float strafeTimer;
-    float windup;
+    Uint64 rng;     // own rng so the move pass can run on any thread
+    bool los;       // saw the player at the last sight check
+    int losWait;    // ticks until the next one
+    float aiDt;     // time banked while far AI LOD skipped it
+
+    // set by the move pass, applied in the serial resolve pass
+    bool windupReq;
+    bool shotReq;
+    float shotX, shotY;
+    float shotDx, shotDy;
+    bool tookBullet;    // resolve only, one bullet per enemy per tick
+
+    // stress mode burst emitter, EMIT_NONE in the normal game
+    EmitKind emit;
+    int emitCount;      // bullets per burst
+    float emitInterval;
+    float emitAngle;
+    float emitTurn;     // added to emitAngle every burst
+    float emitSpeed;
+    int emitReq;        // bursts due this tick (move pass -> resolve)
 } Enemy;
 
 typedef struct {
     float x, y;
+    float px, py;   // start of this tick's path
     float vx, vy;
     float r;
     bool alive;
+    bool fresh;     // fired this tick, already at its end-of-tick spot
 } Bullet;
 
+// enemy bullets as a structure of arrays, the move/collide loops only stream
+// what they use. live ones are packed in [0, count), spawn appends and the
+// dead get squeezed out once per tick, so 50k of them cost nothing to find
 typedef struct {
-    float x, y;
-    float vx, vy;
-    float r;
-    int dmg;
-    bool alive;
-} EnemyBullet;
+    float* x;
+    float* y;
+    float* px;      // start of this tick's path
+    float* py;
+    float* vx;
+    float* vy;
+    int* dmg;
+    bool* alive;
+    int count;
+    int cap;
+} EBulletPool;
 
+// hits on one target close together add up in one number
 typedef struct {
-    float x, y;
+    float x, y;         // over the target at its last hit, floats up from there
     int value;
-    float t;
-    bool alive;
+    Uint32 born;        // game clock ms of the last hit
+    Uint32 target;      // enemy slot + 1, 0 = the player
+    Uint32 targetGen;   // enemy generation, a reused slot is another target
 } DamageNum;
 
 typedef struct {
     float x, y;
+    float px, py;   // position at the start of the tick
     float size;
     float speed;
 
     float dashSpeed;
     float dashTime;
     float dashCooldown;
-    float dashTimer;
-    float cooldownTimer;
+    bool dashReady;
 
     float dx, dy;
     bool dashing;
@@ -87,33 +188,54 @@ typedef struct {
     float fireTimer;
 
     float reloadTime;
-    float reloadTimer;
+    double reloadDone;  // game clock the reload finishes at
     bool reloading;
 
     // i-frames
     float iFrameTime;
-    float iFrameTimer;
+    bool iFrames;
 } Player;
 
-typedef struct {
-    char name[NAME_MAX];
-    int bestKills;
-} ScoreEntry;
-
-typedef struct {
+typedef struct Game {
     float worldW, worldH;
+    float viewW, viewH;     // screen size, the camera shows this much of the world
+    float camX, camY;       // top-left of the view in the world, follows the player
+    // part of the world that simulates (grids, flow, bullets): all of it,
+    // or the active chunks of a streamed world
+    float areaX, areaY, areaW, areaH;
 
     GameState state;
+    GameMode mode;
 
     Player p;
-    Enemy enemies[MAX_ENEMIES];
-    Bullet bullets[MAX_BULLETS];
-    EnemyBullet ebullets[MAX_EBULLETS];
-    DamageNum dmgnums[MAX_DMG_NUMS];
+    Enemy* enemies;
+    Bullet* bullets;
+    EBulletPool eb;
+    int maxEnemies, maxBullets;
+    DamageNum dmgnums[MAX_DMG_NUMS];    // live ones packed, oldest last hit first
+    int dmgCount;
 
     float spawnTimer;
+    double clock;       // s of play this run
+    TimerWheel timers;  // on the clock in ms: i-frames, reload, dash, archers, emitters
+    Uint32 aiTick;      // far AI LOD stagger
+    int aiFar;          // enemies past the near rect at the last move pass
     bool hit;
     int hitDmg;
+    float damageTick;
+
+    EventRing events;       // hits, kills, deaths, shots as they happen in the step
+    EventReader eventsGame; // the game's own consumers (damage numbers, score), after the step
+
+    ContactList contacts;
+    CollideBatch batch;
+    Grid crowd;         // enemies at the start of the tick, for separation
+    FlowField flow;     // chaser directions toward the player
+    TileMap tiles;      // arena walls, loaded once (streamed: the active window)
+    WorldStream* stream;    // NULL = the whole world is in memory
+    ContactList chunkContacts[PAR_CHUNKS];
+    JobPool* jobs;
+    Kernels kern;
 
     int kills;
     int lastRunKills;
@@ -129,14 +251,85 @@ typedef struct {
     char playerName[NAME_MAX];      
     int nameLen;
 
-    ScoreEntry scores[SCORE_MAX];
-    int scoreCount;
+    ScoreState score;   // all-time, week and today boards
+    ScoreWindow board;  // which one the menu shows
+    ScoreSync scoreSync;
 
     bool prevEnter;
     bool prevR;
 } Game;
 
+// everything Game_Update reads from the outside world for one tick
+// (mouse state can only be read on the main thread, so it comes in here)
+typedef struct {
+    bool keys[SDL_SCANCODE_COUNT];
+    float mouseX, mouseY;
+    SDL_MouseButtonFlags mouse;
+} GameInput;
+
+// consecutive rects sharing a color, drawn with one SDL_RenderFillRects
+typedef struct {
+    SDL_Color color;
+    int first, count;
+} ViewRun;
+
+typedef struct {
+    float x, y;
+    int value;
+} ViewNum;
+
+// immutable copy of what Game_Render needs, filled by Game_Snapshot
+// the sim thread fills one while the main thread draws another
+typedef struct {
+    GameState state;
+    GameMode mode;
+    float viewW, viewH;
+
+    // world (in screen space, culled to the view): enemies, bullets, player in draw order
+    SDL_FRect* rects;
+    int rectCount, rectCap;
+    ViewRun* runs;
+    int runCount, runCap;
+
+    ViewNum nums[MAX_DMG_NUMS];
+    int numCount;
+
+    // hud
+    int hp, hpMax;
+    int kills;
+    int mag, reserve;
+    bool reloading;
+    float reloadT;      // 0..1
+    int ebCount;        // live enemy bullets (stress hud)
+
+    // menu / death screen
+    char playerName[NAME_MAX];
+    bool nameLocked;
+    int lastRunKills;
+    int yourBest;
+
+    ScoreWindow board;
+    ScoreEntry top[LEADER_TOP];
+    int topCount;
+    int boardRank, boardRuns, boardPct;     // boardRank 0 = no run on this board
+    int deathRank, deathRuns, deathPct;
+
+    // input latency mode, set by the sim (0 = no action event yet)
+    Uint64 inputTs;         // timestamp of the newest action event in this view
+    Uint64 inputApplied;    // when the sim applied it
+} GameView;
+
 void Game_Init(Game* g, float worldW, float worldH);
 void Game_HandleEvent(Game* g, const SDL_Event* e);
-void Game_Update(Game* g, const bool* keys, float dt);
-void Game_Render(Game* g, SDL_Renderer* renderer);
+void Game_Update(Game* g, const GameInput* in, float dt);
+void Game_Snapshot(const Game* g, GameView* v);
+void Game_Render(const GameView* v, SDL_Renderer* renderer);
+void GameView_Free(GameView* v);
+void Game_Shutdown(Game* g);
+bool Game_Reserve(Game* g, int enemies, int bullets, int ebullets);
+void Game_SetMode(Game* g, GameMode mode);
+// screen size when the world is bigger than the window, defaults to the world
+void Game_SetView(Game* g, float w, float h);
+// swaps the world for one streamed from a world file, sized by it
+// (call before Game_SetView). false = keeps the current one
+bool Game_OpenWorld(Game* g, const char* path);
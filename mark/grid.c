@@ -0,0 +1,104 @@
+#include "grid.h"
+
+#define AT(p, i, stride) (*(const float*)((const char*)(p) + (size_t)(i) * (stride)))
+
+static int cell_of(const Grid* gr, float x, float y)
+{
+    int c = SDL_clamp((int)((x - gr->ox) / gr->cell), 0, gr->cols - 1);
+    int r = SDL_clamp((int)((y - gr->oy) / gr->cell), 0, gr->rows - 1);
+    return r * gr->cols + c;
+}
+
+static bool reserve(Grid* gr, int cells, int items)
+{
+    if (gr->cellCap < cells + 1) {
+        int* start = (int*)SDL_realloc(gr->start, sizeof(int) * (size_t)(cells + 1));
+        if (!start) return false;
+        gr->start = start;
+        gr->cellCap = cells + 1;
+    }
+    if (gr->itemCap < items) {
+        int* slot = (int*)SDL_realloc(gr->slot, sizeof(int) * (size_t)items);
+        if (slot) gr->slot = slot;
+        float* x = (float*)SDL_realloc(gr->x, sizeof(float) * (size_t)items);
+        if (x) gr->x = x;
+        float* y = (float*)SDL_realloc(gr->y, sizeof(float) * (size_t)items);
+        if (y) gr->y = y;
+        float* size = (float*)SDL_realloc(gr->size, sizeof(float) * (size_t)items);
+        if (size) gr->size = size;
+        if (!slot || !x || !y || !size) return false;
+        gr->itemCap = items;
+    }
+    return true;
+}
+
+static void point(const float* x, const float* y, const float* size, size_t stride, int i,
+                  float* px, float* py, float* ps)
+{
+    *px = AT(x, i, stride);
+    *py = AT(y, i, stride);
+    *ps = 0.0f;
+    if (size) {
+        *ps = AT(size, i, stride);
+        *px += *ps * 0.5f;
+        *py += *ps * 0.5f;
+    }
+}
+
+bool Grid_Build(Grid* gr, float cell, float x0, float y0, float w, float h,
+                const float* x, const float* y, const float* size, const bool* use,
+                size_t stride, int n)
+{
+    int cols = (int)(w / cell) + 1;
+    int rows = (int)(h / cell) + 1;
+    if (!reserve(gr, cols * rows, n)) {
+        gr->count = 0;
+        return false;
+    }
+
+    gr->cell = cell;
+    gr->ox = x0;
+    gr->oy = y0;
+    gr->cols = cols;
+    gr->rows = rows;
+
+    int cells = cols * rows;
+    SDL_memset(gr->start, 0, sizeof(int) * (size_t)(cells + 1));
+
+    // count per cell (shifted by one), then prefix sum = where each cell begins
+    for (int i = 0; i < n; i++) {
+        if (use && !*(const bool*)((const char*)use + (size_t)i * stride)) continue;
+        float px, py, ps;
+        point(x, y, size, stride, i, &px, &py, &ps);
+        gr->start[cell_of(gr, px, py) + 1]++;
+    }
+    for (int c = 0; c < cells; c++) gr->start[c + 1] += gr->start[c];
+    gr->count = gr->start[cells];
+
+    // place in input order, start[c] walks to the end of its cell
+    for (int i = 0; i < n; i++) {
+        if (use && !*(const bool*)((const char*)use + (size_t)i * stride)) continue;
+        float px, py, ps;
+        point(x, y, size, stride, i, &px, &py, &ps);
+        int k = gr->start[cell_of(gr, px, py)]++;
+        gr->slot[k] = i;
+        gr->x[k] = px;
+        gr->y[k] = py;
+        gr->size[k] = ps;
+    }
+
+    // every start is now the next cell's, shift them back
+    for (int c = cells; c > 0; c--) gr->start[c] = gr->start[c - 1];
+    gr->start[0] = 0;
+    return true;
+}
+
+void Grid_Free(Grid* gr)
+{
+    SDL_free(gr->start);
+    SDL_free(gr->slot);
+    SDL_free(gr->x);
+    SDL_free(gr->y);
+    SDL_free(gr->size);
+    SDL_zerop(gr);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+// uniform grid over the world (or the part of it that's simulated),
+// rebuilt from scratch each tick with a counting sort. points outside
+// the area land in the edge cells
+typedef struct {
+    float cell;
+    float ox, oy;   // world position of cell 0's corner
+    int cols, rows;
+
+    // entries of cell c are [start[c], start[c + 1]), in point order
+    int* start;
+    int* slot;      // index of each entry in the input
+    float* x;       // its position, copied next to it for the query loops
+    float* y;
+    float* size;    // box size, when built from boxes
+    int count;
+
+    int cellCap, itemCap;
+} Grid;
+
+// n points read with a byte stride so a struct array works in place,
+// e.g. (&enemies[0].x, &enemies[0].y, &enemies[0].size, &enemies[0].alive, sizeof(Enemy))
+// size = optional, x/y are then square boxes and the grid keys on their centers
+// use = optional flag per point, false leaves it out
+// (x0, y0, w, h) = area covered, the whole world unless it's streamed
+bool Grid_Build(Grid* gr, float cell, float x0, float y0, float w, float h,
+                const float* x, const float* y, const float* size, const bool* use,
+                size_t stride, int n);
+void Grid_Free(Grid* gr);
+
+// cell range covering the box (x0, y0) - (x1, y1), inclusive
+static inline void Grid_Range(const Grid* gr, float x0, float y0, float x1, float y1,
+                              int* c0, int* r0, int* c1, int* r1)
+{
+    *c0 = SDL_clamp((int)((x0 - gr->ox) / gr->cell), 0, gr->cols - 1);
+    *r0 = SDL_clamp((int)((y0 - gr->oy) / gr->cell), 0, gr->rows - 1);
+    *c1 = SDL_clamp((int)((x1 - gr->ox) / gr->cell), 0, gr->cols - 1);
+    *r1 = SDL_clamp((int)((y1 - gr->oy) / gr->cell), 0, gr->rows - 1);
+}
@@ -0,0 +1,47 @@
+#include "input.h"
+
+void Input_Init(InputQueue* q)
+{
+    SDL_SetAtomicInt(&q->head, 0);
+    SDL_SetAtomicInt(&q->tail, 0);
+    q->dropped = 0;
+}
+
+bool Input_Push(InputQueue* q, const SDL_Event* e)
+{
+    Uint32 head = (Uint32)SDL_GetAtomicInt(&q->head);
+    Uint32 tail = (Uint32)SDL_GetAtomicInt(&q->tail);
+
+    if (head - tail >= INPUT_QUEUE) {
+        // sim stalled for a long time, newest input is the one that goes
+        if ((q->dropped++ % 256) == 0) SDL_Log("input queue full, dropping events");
+        return false;
+    }
+
+    InputEvent* ev = &q->items[head & (INPUT_QUEUE - 1)];
+    ev->e = *e;
+    ev->text[0] = 0;
+    if (e->type == SDL_EVENT_TEXT_INPUT && e->text.text)
+        SDL_strlcpy(ev->text, e->text.text, INPUT_TEXT);
+
+    // slot is written before the new head is visible
+    SDL_SetAtomicInt(&q->head, (int)(head + 1));
+    return true;
+}
+
+InputEvent* Input_Peek(InputQueue* q)
+{
+    Uint32 tail = (Uint32)SDL_GetAtomicInt(&q->tail);
+    Uint32 head = (Uint32)SDL_GetAtomicInt(&q->head);
+    if (head == tail) return NULL;
+
+    InputEvent* ev = &q->items[tail & (INPUT_QUEUE - 1)];
+    if (ev->e.type == SDL_EVENT_TEXT_INPUT) ev->e.text.text = ev->text;
+    return ev;
+}
+
+void Input_Pop(InputQueue* q)
+{
+    Uint32 tail = (Uint32)SDL_GetAtomicInt(&q->tail);
+    SDL_SetAtomicInt(&q->tail, (int)(tail + 1));
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+#define INPUT_QUEUE 1024    // power of two
+#define INPUT_TEXT  32
+
+// e.common.timestamp is SDL_GetTicksNS time of the event
+// text input points into SDL's per-poll memory, so the text gets copied
+typedef struct {
+    SDL_Event e;
+    char text[INPUT_TEXT];
+} InputEvent;
+
+// lock-free ring, one producer (event pump) and one consumer (sim)
+typedef struct {
+    InputEvent items[INPUT_QUEUE];
+    SDL_AtomicInt head;     // next write, only the producer stores it
+    SDL_AtomicInt tail;     // next read, only the consumer stores it
+    int dropped;            // producer side
+} InputQueue;
+
+void        Input_Init(InputQueue* q);
+bool        Input_Push(InputQueue* q, const SDL_Event* e);
+InputEvent* Input_Peek(InputQueue* q);
+void        Input_Pop(InputQueue* q);
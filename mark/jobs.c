@@ -0,0 +1,135 @@
+#include "jobs.h"
+
+struct JobPool {
+    SDL_Thread* threads[JOBS_MAX_THREADS];
+    int threadCount;
+
+    SDL_Mutex* mutex;
+    SDL_Condition* wake;
+    SDL_Condition* done;
+    bool quit;
+
+    // current job, only changed under mutex while every worker is parked
+    int generation;
+    int acked;
+    JobFn fn;
+    void* ctx;
+    int chunks;
+    SDL_AtomicInt next;
+};
+
+static void run_chunks(JobPool* pool, JobFn fn, void* ctx, int chunks)
+{
+    for (;;) {
+        int c = SDL_AddAtomicInt(&pool->next, 1);
+        if (c >= chunks) break;
+        fn(ctx, c);
+    }
+}
+
+static int SDLCALL worker(void* data)
+{
+    JobPool* pool = (JobPool*)data;
+    int seen = 0;
+
+    SDL_LockMutex(pool->mutex);
+    for (;;) {
+        while (pool->generation == seen && !pool->quit)
+            SDL_WaitCondition(pool->wake, pool->mutex);
+        if (pool->quit) break;
+
+        seen = pool->generation;
+        JobFn fn = pool->fn;
+        void* ctx = pool->ctx;
+        int chunks = pool->chunks;
+        SDL_UnlockMutex(pool->mutex);
+
+        run_chunks(pool, fn, ctx, chunks);
+
+        SDL_LockMutex(pool->mutex);
+        pool->acked++;
+        if (pool->acked == pool->threadCount) SDL_SignalCondition(pool->done);
+    }
+    SDL_UnlockMutex(pool->mutex);
+    return 0;
+}
+
+JobPool* Jobs_Create(int workers)
+{
+    if (workers <= 0) workers = SDL_GetNumLogicalCPUCores() - 1;
+    if (workers > JOBS_MAX_THREADS) workers = JOBS_MAX_THREADS;
+
+    JobPool* pool = (JobPool*)SDL_calloc(1, sizeof(JobPool));
+    if (!pool) return NULL;
+
+    pool->mutex = SDL_CreateMutex();
+    pool->wake = SDL_CreateCondition();
+    pool->done = SDL_CreateCondition();
+    if (!pool->mutex || !pool->wake || !pool->done) {
+        Jobs_Destroy(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < workers; i++) {
+        SDL_Thread* t = SDL_CreateThread(worker, "mark_job", pool);
+        if (!t) {
+            SDL_Log("job thread %d failed: %s", i, SDL_GetError());
+            break;
+        }
+        pool->threads[pool->threadCount++] = t;
+    }
+    return pool;
+}
+
+void Jobs_Destroy(JobPool* pool)
+{
+    if (!pool) return;
+
+    if (pool->mutex) {
+        SDL_LockMutex(pool->mutex);
+        pool->quit = true;
+        if (pool->wake) SDL_BroadcastCondition(pool->wake);
+        SDL_UnlockMutex(pool->mutex);
+    }
+
+    for (int i = 0; i < pool->threadCount; i++)
+        SDL_WaitThread(pool->threads[i], NULL);
+
+    if (pool->done) SDL_DestroyCondition(pool->done);
+    if (pool->wake) SDL_DestroyCondition(pool->wake);
+    if (pool->mutex) SDL_DestroyMutex(pool->mutex);
+    SDL_free(pool);
+}
+
+int Jobs_Threads(const JobPool* pool)
+{
+    return pool ? pool->threadCount + 1 : 1;
+}
+
+void Jobs_Run(JobPool* pool, int chunks, JobFn fn, void* ctx)
+{
+    if (chunks <= 0) return;
+
+    if (!pool || pool->threadCount == 0 || chunks == 1) {
+        for (int c = 0; c < chunks; c++) fn(ctx, c);
+        return;
+    }
+
+    SDL_LockMutex(pool->mutex);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->chunks = chunks;
+    pool->acked = 0;
+    SDL_SetAtomicInt(&pool->next, 0);
+    pool->generation++;
+    SDL_BroadcastCondition(pool->wake);
+    SDL_UnlockMutex(pool->mutex);
+
+    run_chunks(pool, fn, ctx, chunks);
+
+    // every worker has to check in before the next job can reset the counter
+    SDL_LockMutex(pool->mutex);
+    while (pool->acked < pool->threadCount)
+        SDL_WaitCondition(pool->done, pool->mutex);
+    SDL_UnlockMutex(pool->mutex);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+#define JOBS_MAX_THREADS 15
+
+// chunk = index of the slice to do, 0..chunks-1
+typedef void (*JobFn)(void* ctx, int chunk);
+
+typedef struct JobPool JobPool;
+
+// workers = 0 picks cores - 1, calling thread always helps
+JobPool* Jobs_Create(int workers);
+void     Jobs_Destroy(JobPool* pool);
+int      Jobs_Threads(const JobPool* pool);
+
+// runs fn on every chunk and returns once all of them are done
+void     Jobs_Run(JobPool* pool, int chunks, JobFn fn, void* ctx);
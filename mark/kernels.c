@@ -0,0 +1,530 @@
+#include "kernels.h"
+#include <SDL3/SDL_intrin.h>
+
+// the vector versions do the same ops in the same order as the scalar ones
+// (mul then add, no fma, ieee sqrt/div), which is what keeps exact mode exact
+
+/* ------------------ scalar ------------------ */
+
+static void integrate_scalar(float* x, float* y, float* px, float* py,
+                             const float* vx, const float* vy, bool* alive, int n,
+                             float dt, float minX, float minY, float maxX, float maxY)
+{
+    for (int i = 0; i < n; i++) {
+        px[i] = x[i];
+        py[i] = y[i];
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+
+        if (x[i] < minX || x[i] > maxX || y[i] < minY || y[i] > maxY)
+            alive[i] = false;
+    }
+}
+
+static void chase_scalar(float* x, float* y, const float* speed, int n,
+                         float tx, float ty, float dt)
+{
+    for (int i = 0; i < n; i++) {
+        float ex = x[i] - tx;
+        float ey = y[i] - ty;
+        float d = SDL_sqrtf(ex * ex + ey * ey);
+        if (d > 0.0f) { ex /= d; ey /= d; }
+
+        x[i] -= ex * speed[i] * dt;
+        y[i] -= ey * speed[i] * dt;
+    }
+}
+
+// one path, the reference the vector versions have to match bit for bit
+static float sweep_one(float x0, float y0, float x1, float y1,
+                       float bx, float by, float bw, float bh)
+{
+    // cheap reject on the path bounds first, most pairs end here
+    if (SDL_max(x0, x1) < bx || SDL_min(x0, x1) > bx + bw ||
+        SDL_max(y0, y1) < by || SDL_min(y0, y1) > by + bh)
+        return -1.0f;
+
+    float tmin = 0.0f, tmax = 1.0f;
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+
+    if (dx != 0.0f) {
+        float t0 = (bx - x0) / dx;
+        float t1 = (bx + bw - x0) / dx;
+        if (t0 > t1) { float tt = t0; t0 = t1; t1 = tt; }
+        if (t0 > tmin) tmin = t0;
+        if (t1 < tmax) tmax = t1;
+    }
+    else if (x0 <= bx || x0 >= bx + bw) return -1.0f;
+
+    if (dy != 0.0f) {
+        float t0 = (by - y0) / dy;
+        float t1 = (by + bh - y0) / dy;
+        if (t0 > t1) { float tt = t0; t0 = t1; t1 = tt; }
+        if (t0 > tmin) tmin = t0;
+        if (t1 < tmax) tmax = t1;
+    }
+    else if (y0 <= by || y0 >= by + bh) return -1.0f;
+
+    return (tmin <= tmax) ? tmin : -1.0f;
+}
+
+// [begin, n) one at a time, mask bits are absolute so the vector versions finish with it
+static int sweep_from(const float* x0, const float* y0, const float* x1, const float* y1, int begin, int n,
+                      float ox, float oy, float bx, float by, float bw, float bh,
+                      Uint32* mask, float* t)
+{
+    int hits = 0;
+    for (int i = begin; i < n; i++) {
+        t[i] = sweep_one(x0[i] + ox, y0[i] + oy, x1[i], y1[i], bx, by, bw, bh);
+        if (t[i] >= 0.0f) {
+            mask[i >> 5] |= 1u << (i & 31);
+            hits++;
+        }
+    }
+    return hits;
+}
+
+static int overlap_from(const float* x, const float* y, const float* size, int begin, int n,
+                        float bx, float by, float bw, float bh, Uint32* mask)
+{
+    int hits = 0;
+    for (int i = begin; i < n; i++) {
+        bool hit =
+            x[i] < bx + bw &&
+            x[i] + size[i] > bx &&
+            y[i] < by + bh &&
+            y[i] + size[i] > by;
+        if (hit) {
+            mask[i >> 5] |= 1u << (i & 31);
+            hits++;
+        }
+    }
+    return hits;
+}
+
+static void clear_mask(Uint32* mask, int n)
+{
+    SDL_memset(mask, 0, (size_t)((n + 31) / 32) * sizeof(Uint32));
+}
+
+static int sweep_scalar(const float* x0, const float* y0, const float* x1, const float* y1, int n,
+                        float ox, float oy, float bx, float by, float bw, float bh,
+                        Uint32* mask, float* t)
+{
+    clear_mask(mask, n);
+    return sweep_from(x0, y0, x1, y1, 0, n, ox, oy, bx, by, bw, bh, mask, t);
+}
+
+static int overlap_scalar(const float* x, const float* y, const float* size, int n,
+                          float bx, float by, float bw, float bh, Uint32* mask)
+{
+    clear_mask(mask, n);
+    return overlap_from(x, y, size, 0, n, bx, by, bw, bh, mask);
+}
+
+// set bits in a movemask
+static int lane_count(int m)
+{
+    int n = 0;
+    for (; m; m &= m - 1) n++;
+    return n;
+}
+
+// lanes that left the box, as bits
+static void kill_lanes(bool* alive, int mask)
+{
+    for (int k = 0; mask; k++, mask >>= 1)
+        if (mask & 1) alive[k] = false;
+}
+
+/* ------------------ sse4.1 ------------------ */
+
+#ifdef SDL_SSE4_1_INTRINSICS
+
+static void SDL_TARGETING("sse4.1") integrate_sse41(float* x, float* y, float* px, float* py,
+                            const float* vx, const float* vy, bool* alive, int n,
+                            float dt, float minX, float minY, float maxX, float maxY)
+{
+    __m128 vdt = _mm_set1_ps(dt);
+    __m128 lo_x = _mm_set1_ps(minX), lo_y = _mm_set1_ps(minY);
+    __m128 hi_x = _mm_set1_ps(maxX), hi_y = _mm_set1_ps(maxY);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 ox = _mm_loadu_ps(x + i);
+        __m128 oy = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(px + i, ox);
+        _mm_storeu_ps(py + i, oy);
+
+        __m128 nx = _mm_add_ps(ox, _mm_mul_ps(_mm_loadu_ps(vx + i), vdt));
+        __m128 ny = _mm_add_ps(oy, _mm_mul_ps(_mm_loadu_ps(vy + i), vdt));
+        _mm_storeu_ps(x + i, nx);
+        _mm_storeu_ps(y + i, ny);
+
+        __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(nx, lo_x), _mm_cmpgt_ps(nx, hi_x)),
+                               _mm_or_ps(_mm_cmplt_ps(ny, lo_y), _mm_cmpgt_ps(ny, hi_y)));
+        int m = _mm_movemask_ps(out);
+        if (m) kill_lanes(alive + i, m);
+    }
+
+    integrate_scalar(x + i, y + i, px + i, py + i, vx + i, vy + i, alive + i, n - i,
+                     dt, minX, minY, maxX, maxY);
+}
+
+static void SDL_TARGETING("sse4.1") chase_sse41_impl(float* x, float* y, const float* speed, int n,
+                            float tx, float ty, float dt, bool exact)
+{
+    __m128 vtx = _mm_set1_ps(tx), vty = _mm_set1_ps(ty);
+    __m128 vdt = _mm_set1_ps(dt);
+    __m128 zero = _mm_setzero_ps();
+    __m128 half = _mm_set1_ps(0.5f), three = _mm_set1_ps(3.0f);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 ox = _mm_loadu_ps(x + i);
+        __m128 oy = _mm_loadu_ps(y + i);
+        __m128 ex = _mm_sub_ps(ox, vtx);
+        __m128 ey = _mm_sub_ps(oy, vty);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+        __m128 nx, ny, ok;
+        if (exact) {
+            __m128 d = _mm_sqrt_ps(d2);
+            ok = _mm_cmpgt_ps(d, zero);
+            nx = _mm_div_ps(ex, d);
+            ny = _mm_div_ps(ey, d);
+        }
+        else {
+            // one newton step on rsqrt, ~22 bits
+            __m128 r = _mm_rsqrt_ps(d2);
+            r = _mm_mul_ps(_mm_mul_ps(half, r), _mm_sub_ps(three, _mm_mul_ps(d2, _mm_mul_ps(r, r))));
+            ok = _mm_cmpgt_ps(d2, zero);
+            nx = _mm_mul_ps(ex, r);
+            ny = _mm_mul_ps(ey, r);
+        }
+        ex = _mm_blendv_ps(ex, nx, ok);
+        ey = _mm_blendv_ps(ey, ny, ok);
+
+        __m128 s = _mm_loadu_ps(speed + i);
+        _mm_storeu_ps(x + i, _mm_sub_ps(ox, _mm_mul_ps(_mm_mul_ps(ex, s), vdt)));
+        _mm_storeu_ps(y + i, _mm_sub_ps(oy, _mm_mul_ps(_mm_mul_ps(ey, s), vdt)));
+    }
+
+    chase_scalar(x + i, y + i, speed + i, n - i, tx, ty, dt);
+}
+
+static void chase_sse41(float* x, float* y, const float* speed, int n, float tx, float ty, float dt)
+{
+    chase_sse41_impl(x, y, speed, n, tx, ty, dt, true);
+}
+
+static void chase_sse41_fast(float* x, float* y, const float* speed, int n, float tx, float ty, float dt)
+{
+    chase_sse41_impl(x, y, speed, n, tx, ty, dt, false);
+}
+
+// same steps as sweep_one, every lane at once, dx == 0 lanes take the else branch
+static int SDL_TARGETING("sse4.1") sweep_sse41(const float* x0, const float* y0, const float* x1, const float* y1, int n,
+                            float ox, float oy, float bx, float by, float bw, float bh,
+                            Uint32* mask, float* t)
+{
+    clear_mask(mask, n);
+
+    __m128 vox = _mm_set1_ps(ox), voy = _mm_set1_ps(oy);
+    __m128 lx = _mm_set1_ps(bx), hx = _mm_set1_ps(bx + bw);
+    __m128 ly = _mm_set1_ps(by), hy = _mm_set1_ps(by + bh);
+    __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), miss = _mm_set1_ps(-1.0f);
+
+    int hits = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 ax = _mm_add_ps(_mm_loadu_ps(x0 + i), vox);
+        __m128 ay = _mm_add_ps(_mm_loadu_ps(y0 + i), voy);
+        __m128 ex = _mm_loadu_ps(x1 + i);
+        __m128 ey = _mm_loadu_ps(y1 + i);
+
+        __m128 out = _mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(_mm_max_ps(ax, ex), lx), _mm_cmpgt_ps(_mm_min_ps(ax, ex), hx)),
+            _mm_or_ps(_mm_cmplt_ps(_mm_max_ps(ay, ey), ly), _mm_cmpgt_ps(_mm_min_ps(ay, ey), hy)));
+
+        if (_mm_movemask_ps(out) == 0xF) {
+            _mm_storeu_ps(t + i, miss);
+            continue;
+        }
+
+        __m128 dx = _mm_sub_ps(ex, ax);
+        __m128 dy = _mm_sub_ps(ey, ay);
+
+        __m128 kx = _mm_cmpneq_ps(dx, zero);
+        __m128 t0 = _mm_div_ps(_mm_sub_ps(lx, ax), dx);
+        __m128 t1 = _mm_div_ps(_mm_sub_ps(hx, ax), dx);
+        __m128 tmin = _mm_blendv_ps(zero, _mm_max_ps(_mm_min_ps(t0, t1), zero), kx);
+        __m128 tmax = _mm_blendv_ps(one, _mm_min_ps(_mm_max_ps(t0, t1), one), kx);
+        out = _mm_or_ps(out, _mm_andnot_ps(kx, _mm_or_ps(_mm_cmple_ps(ax, lx), _mm_cmpge_ps(ax, hx))));
+
+        __m128 ky = _mm_cmpneq_ps(dy, zero);
+        t0 = _mm_div_ps(_mm_sub_ps(ly, ay), dy);
+        t1 = _mm_div_ps(_mm_sub_ps(hy, ay), dy);
+        tmin = _mm_blendv_ps(tmin, _mm_max_ps(_mm_min_ps(t0, t1), tmin), ky);
+        tmax = _mm_blendv_ps(tmax, _mm_min_ps(_mm_max_ps(t0, t1), tmax), ky);
+        out = _mm_or_ps(out, _mm_andnot_ps(ky, _mm_or_ps(_mm_cmple_ps(ay, ly), _mm_cmpge_ps(ay, hy))));
+
+        __m128 hit = _mm_andnot_ps(out, _mm_cmple_ps(tmin, tmax));
+        _mm_storeu_ps(t + i, _mm_blendv_ps(miss, tmin, hit));
+
+        int m = _mm_movemask_ps(hit);
+        mask[i >> 5] |= (Uint32)m << (i & 31);
+        hits += lane_count(m);
+    }
+
+    return hits + sweep_from(x0, y0, x1, y1, i, n, ox, oy, bx, by, bw, bh, mask, t);
+}
+
+static int SDL_TARGETING("sse4.1") overlap_sse41(const float* x, const float* y, const float* size, int n,
+                            float bx, float by, float bw, float bh, Uint32* mask)
+{
+    clear_mask(mask, n);
+
+    __m128 lx = _mm_set1_ps(bx), hx = _mm_set1_ps(bx + bw);
+    __m128 ly = _mm_set1_ps(by), hy = _mm_set1_ps(by + bh);
+
+    int hits = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vs = _mm_loadu_ps(size + i);
+
+        __m128 hit = _mm_and_ps(
+            _mm_and_ps(_mm_cmplt_ps(vx, hx), _mm_cmpgt_ps(_mm_add_ps(vx, vs), lx)),
+            _mm_and_ps(_mm_cmplt_ps(vy, hy), _mm_cmpgt_ps(_mm_add_ps(vy, vs), ly)));
+
+        int m = _mm_movemask_ps(hit);
+        mask[i >> 5] |= (Uint32)m << (i & 31);
+        hits += lane_count(m);
+    }
+
+    return hits + overlap_from(x, y, size, i, n, bx, by, bw, bh, mask);
+}
+
+#endif
+
+/* ------------------ avx2 ------------------ */
+
+#ifdef SDL_AVX2_INTRINSICS
+
+static void SDL_TARGETING("avx2") integrate_avx2(float* x, float* y, float* px, float* py,
+                            const float* vx, const float* vy, bool* alive, int n,
+                            float dt, float minX, float minY, float maxX, float maxY)
+{
+    __m256 vdt = _mm256_set1_ps(dt);
+    __m256 lo_x = _mm256_set1_ps(minX), lo_y = _mm256_set1_ps(minY);
+    __m256 hi_x = _mm256_set1_ps(maxX), hi_y = _mm256_set1_ps(maxY);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 ox = _mm256_loadu_ps(x + i);
+        __m256 oy = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(px + i, ox);
+        _mm256_storeu_ps(py + i, oy);
+
+        __m256 nx = _mm256_add_ps(ox, _mm256_mul_ps(_mm256_loadu_ps(vx + i), vdt));
+        __m256 ny = _mm256_add_ps(oy, _mm256_mul_ps(_mm256_loadu_ps(vy + i), vdt));
+        _mm256_storeu_ps(x + i, nx);
+        _mm256_storeu_ps(y + i, ny);
+
+        __m256 out = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(nx, lo_x, _CMP_LT_OQ), _mm256_cmp_ps(nx, hi_x, _CMP_GT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(ny, lo_y, _CMP_LT_OQ), _mm256_cmp_ps(ny, hi_y, _CMP_GT_OQ)));
+        int m = _mm256_movemask_ps(out);
+        if (m) kill_lanes(alive + i, m);
+    }
+
+    integrate_scalar(x + i, y + i, px + i, py + i, vx + i, vy + i, alive + i, n - i,
+                     dt, minX, minY, maxX, maxY);
+}
+
+static void SDL_TARGETING("avx2") chase_avx2_impl(float* x, float* y, const float* speed, int n,
+                            float tx, float ty, float dt, bool exact)
+{
+    __m256 vtx = _mm256_set1_ps(tx), vty = _mm256_set1_ps(ty);
+    __m256 vdt = _mm256_set1_ps(dt);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 half = _mm256_set1_ps(0.5f), three = _mm256_set1_ps(3.0f);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 ox = _mm256_loadu_ps(x + i);
+        __m256 oy = _mm256_loadu_ps(y + i);
+        __m256 ex = _mm256_sub_ps(ox, vtx);
+        __m256 ey = _mm256_sub_ps(oy, vty);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+
+        __m256 nx, ny, ok;
+        if (exact) {
+            __m256 d = _mm256_sqrt_ps(d2);
+            ok = _mm256_cmp_ps(d, zero, _CMP_GT_OQ);
+            nx = _mm256_div_ps(ex, d);
+            ny = _mm256_div_ps(ey, d);
+        }
+        else {
+            __m256 r = _mm256_rsqrt_ps(d2);
+            r = _mm256_mul_ps(_mm256_mul_ps(half, r), _mm256_sub_ps(three, _mm256_mul_ps(d2, _mm256_mul_ps(r, r))));
+            ok = _mm256_cmp_ps(d2, zero, _CMP_GT_OQ);
+            nx = _mm256_mul_ps(ex, r);
+            ny = _mm256_mul_ps(ey, r);
+        }
+        ex = _mm256_blendv_ps(ex, nx, ok);
+        ey = _mm256_blendv_ps(ey, ny, ok);
+
+        __m256 s = _mm256_loadu_ps(speed + i);
+        _mm256_storeu_ps(x + i, _mm256_sub_ps(ox, _mm256_mul_ps(_mm256_mul_ps(ex, s), vdt)));
+        _mm256_storeu_ps(y + i, _mm256_sub_ps(oy, _mm256_mul_ps(_mm256_mul_ps(ey, s), vdt)));
+    }
+
+    chase_scalar(x + i, y + i, speed + i, n - i, tx, ty, dt);
+}
+
+static void chase_avx2(float* x, float* y, const float* speed, int n, float tx, float ty, float dt)
+{
+    chase_avx2_impl(x, y, speed, n, tx, ty, dt, true);
+}
+
+static void chase_avx2_fast(float* x, float* y, const float* speed, int n, float tx, float ty, float dt)
+{
+    chase_avx2_impl(x, y, speed, n, tx, ty, dt, false);
+}
+
+static int SDL_TARGETING("avx2") sweep_avx2(const float* x0, const float* y0, const float* x1, const float* y1, int n,
+                            float ox, float oy, float bx, float by, float bw, float bh,
+                            Uint32* mask, float* t)
+{
+    clear_mask(mask, n);
+
+    __m256 vox = _mm256_set1_ps(ox), voy = _mm256_set1_ps(oy);
+    __m256 lx = _mm256_set1_ps(bx), hx = _mm256_set1_ps(bx + bw);
+    __m256 ly = _mm256_set1_ps(by), hy = _mm256_set1_ps(by + bh);
+    __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), miss = _mm256_set1_ps(-1.0f);
+
+    int hits = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 ax = _mm256_add_ps(_mm256_loadu_ps(x0 + i), vox);
+        __m256 ay = _mm256_add_ps(_mm256_loadu_ps(y0 + i), voy);
+        __m256 ex = _mm256_loadu_ps(x1 + i);
+        __m256 ey = _mm256_loadu_ps(y1 + i);
+
+        __m256 out = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(_mm256_max_ps(ax, ex), lx, _CMP_LT_OQ),
+                         _mm256_cmp_ps(_mm256_min_ps(ax, ex), hx, _CMP_GT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(_mm256_max_ps(ay, ey), ly, _CMP_LT_OQ),
+                         _mm256_cmp_ps(_mm256_min_ps(ay, ey), hy, _CMP_GT_OQ)));
+
+        // cheap reject for the whole group before the divides
+        if (_mm256_movemask_ps(out) == 0xFF) {
+            _mm256_storeu_ps(t + i, miss);
+            continue;
+        }
+
+        __m256 dx = _mm256_sub_ps(ex, ax);
+        __m256 dy = _mm256_sub_ps(ey, ay);
+
+        __m256 kx = _mm256_cmp_ps(dx, zero, _CMP_NEQ_UQ);
+        __m256 t0 = _mm256_div_ps(_mm256_sub_ps(lx, ax), dx);
+        __m256 t1 = _mm256_div_ps(_mm256_sub_ps(hx, ax), dx);
+        __m256 tmin = _mm256_blendv_ps(zero, _mm256_max_ps(_mm256_min_ps(t0, t1), zero), kx);
+        __m256 tmax = _mm256_blendv_ps(one, _mm256_min_ps(_mm256_max_ps(t0, t1), one), kx);
+        out = _mm256_or_ps(out, _mm256_andnot_ps(kx, _mm256_or_ps(
+            _mm256_cmp_ps(ax, lx, _CMP_LE_OQ), _mm256_cmp_ps(ax, hx, _CMP_GE_OQ))));
+
+        __m256 ky = _mm256_cmp_ps(dy, zero, _CMP_NEQ_UQ);
+        t0 = _mm256_div_ps(_mm256_sub_ps(ly, ay), dy);
+        t1 = _mm256_div_ps(_mm256_sub_ps(hy, ay), dy);
+        tmin = _mm256_blendv_ps(tmin, _mm256_max_ps(_mm256_min_ps(t0, t1), tmin), ky);
+        tmax = _mm256_blendv_ps(tmax, _mm256_min_ps(_mm256_max_ps(t0, t1), tmax), ky);
+        out = _mm256_or_ps(out, _mm256_andnot_ps(ky, _mm256_or_ps(
+            _mm256_cmp_ps(ay, ly, _CMP_LE_OQ), _mm256_cmp_ps(ay, hy, _CMP_GE_OQ))));
+
+        __m256 hit = _mm256_andnot_ps(out, _mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ));
+        _mm256_storeu_ps(t + i, _mm256_blendv_ps(miss, tmin, hit));
+
+        int m = _mm256_movemask_ps(hit);
+        mask[i >> 5] |= (Uint32)m << (i & 31);
+        hits += lane_count(m);
+    }
+
+    return hits + sweep_from(x0, y0, x1, y1, i, n, ox, oy, bx, by, bw, bh, mask, t);
+}
+
+static int SDL_TARGETING("avx2") overlap_avx2(const float* x, const float* y, const float* size, int n,
+                            float bx, float by, float bw, float bh, Uint32* mask)
+{
+    clear_mask(mask, n);
+
+    __m256 lx = _mm256_set1_ps(bx), hx = _mm256_set1_ps(bx + bw);
+    __m256 ly = _mm256_set1_ps(by), hy = _mm256_set1_ps(by + bh);
+
+    int hits = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 vs = _mm256_loadu_ps(size + i);
+
+        __m256 hit = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(vx, hx, _CMP_LT_OQ),
+                          _mm256_cmp_ps(_mm256_add_ps(vx, vs), lx, _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(vy, hy, _CMP_LT_OQ),
+                          _mm256_cmp_ps(_mm256_add_ps(vy, vs), ly, _CMP_GT_OQ)));
+
+        int m = _mm256_movemask_ps(hit);
+        mask[i >> 5] |= (Uint32)m << (i & 31);
+        hits += lane_count(m);
+    }
+
+    return hits + overlap_from(x, y, size, i, n, bx, by, bw, bh, mask);
+}
+
+#endif
+
+/* ------------------ dispatch ------------------ */
+
+void Kernels_Select(Kernels* k, KernelLevel max, bool exact)
+{
+    k->level = KERNEL_SCALAR;
+    k->exact = exact;
+    k->integrate = integrate_scalar;
+    k->chase = chase_scalar;
+    k->sweep = sweep_scalar;
+    k->overlap = overlap_scalar;
+
+#ifdef SDL_SSE4_1_INTRINSICS
+    if (max >= KERNEL_SSE41 && SDL_HasSSE41()) {
+        k->level = KERNEL_SSE41;
+        k->integrate = integrate_sse41;
+        k->chase = exact ? chase_sse41 : chase_sse41_fast;
+        k->sweep = sweep_sse41;
+        k->overlap = overlap_sse41;
+    }
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+    if (max >= KERNEL_AVX2 && SDL_HasAVX2()) {
+        k->level = KERNEL_AVX2;
+        k->integrate = integrate_avx2;
+        k->chase = exact ? chase_avx2 : chase_avx2_fast;
+        k->sweep = sweep_avx2;
+        k->overlap = overlap_avx2;
+    }
+#endif
+}
+
+const char* Kernels_Name(KernelLevel level)
+{
+    switch (level) {
+    case KERNEL_SSE41: return "sse4.1";
+    case KERNEL_AVX2:  return "avx2";
+    default:           return "scalar";
+    }
+}
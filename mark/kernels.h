@@ -0,0 +1,48 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+// float loops over plain arrays, scalar + SSE4.1 + AVX2 versions,
+// picked once at startup from what the cpu has
+
+typedef enum {
+    KERNEL_SCALAR = 0,
+    KERNEL_SSE41,
+    KERNEL_AVX2,
+} KernelLevel;
+
+// x += vx * dt, old spot kept in px/py, anything outside min..max dies
+// dead slots get moved too (nothing reads them), alive only ever goes false
+typedef void (*IntegrateFn)(float* x, float* y, float* px, float* py,
+                            const float* vx, const float* vy, bool* alive, int n,
+                            float dt, float minX, float minY, float maxX, float maxY);
+
+// straight at (tx, ty): dir = normalize(x - t), x -= dir * speed * dt
+typedef void (*ChaseFn)(float* x, float* y, const float* speed, int n,
+                        float tx, float ty, float dt);
+
+// paths (x0 + ox, y0 + oy) -> (x1, y1) against one box, slab test
+// t[i] = where the path enters it (0..1) or -1, bit i of mask set on a hit
+// mask needs (n + 31) / 32 words, returns how many hit
+typedef int (*SweepFn)(const float* x0, const float* y0, const float* x1, const float* y1, int n,
+                       float ox, float oy, float bx, float by, float bw, float bh,
+                       Uint32* mask, float* t);
+
+// square boxes (x, y, size) against one box, touching edges don't count
+typedef int (*OverlapFn)(const float* x, const float* y, const float* size, int n,
+                         float bx, float by, float bw, float bh, Uint32* mask);
+
+typedef struct {
+    KernelLevel level;
+    bool exact;
+    IntegrateFn integrate;
+    ChaseFn chase;
+    SweepFn sweep;
+    OverlapFn overlap;
+} Kernels;
+
+// best level the cpu has, up to max
+// exact = same bits as the scalar loop, otherwise chase uses rsqrt
+// (sweep and overlap are always exact)
+void        Kernels_Select(Kernels* k, KernelLevel max, bool exact);
+const char* Kernels_Name(KernelLevel level);
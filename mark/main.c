@@ -4,13 +4,59 @@
 #include <stdbool.h>
 
 #include "game.h"
+#include "sim.h"
 
 #define WINDOW_W 800
 #define WINDOW_H 600
 
+#define LATENCY_REPORT 100  // samples per log line
+
+// --latency: event timestamp -> sim applied it -> frame with it presented
+typedef struct {
+    bool on;
+    Uint64 lastTs;
+    int count;
+    Uint64 simSum, simMax;
+    Uint64 e2eSum, e2eMax;
+} Latency;
+
+static void latency_sample(Latency* l, const GameView* v)
+{
+    if (!l->on || v->inputTs == 0 || v->inputTs == l->lastTs) return;
+    l->lastTs = v->inputTs;
+
+    Uint64 sim = v->inputApplied - v->inputTs;
+    Uint64 e2e = SDL_GetTicksNS() - v->inputTs;
+
+    l->count++;
+    l->simSum += sim;
+    l->e2eSum += e2e;
+    if (sim > l->simMax) l->simMax = sim;
+    if (e2e > l->e2eMax) l->e2eMax = e2e;
+
+    if (l->count == LATENCY_REPORT) {
+        SDL_Log("input latency (%d presses): to sim avg %.2f ms max %.2f ms, to present avg %.2f ms max %.2f ms",
+            l->count,
+            (double)l->simSum / l->count / 1e6, (double)l->simMax / 1e6,
+            (double)l->e2eSum / l->count / 1e6, (double)l->e2eMax / 1e6);
+        l->count = 0;
+        l->simSum = l->simMax = 0;
+        l->e2eSum = l->e2eMax = 0;
+    }
+}
+
 int main(int argc, char* argv[])
 {
-    (void)argc; (void)argv;
+    Latency latency = { 0 };
+    bool stress = false;
+    int world = 1;      // --world N: N x N screens, the camera follows the player
+    const char* stream = NULL;  // --stream FILE: chunked world file, made on first use
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--latency") == 0) latency.on = true;
+        if (SDL_strcmp(argv[i], "--stress") == 0) stress = true;
+        if (SDL_strcmp(argv[i], "--world") == 0 && i + 1 < argc) world = SDL_clamp(SDL_atoi(argv[++i]), 1, 64);
+        if (SDL_strcmp(argv[i], "--stream") == 0 && i + 1 < argc) stream = argv[++i];
+    }
 
     SDL_SetMainReady();
 
@@ -36,33 +82,54 @@ int main(int argc, char* argv[])
     SDL_StartTextInput(window);
 
     Game game;
-    Game_Init(&game, (float)WINDOW_W, (float)WINDOW_H);
+    Game_Init(&game, (float)(WINDOW_W * world), (float)(WINDOW_H * world));
+    if (stream) {
+        // 64 x 64 chunks of 1024 px, only the ones around the camera are in memory
+        SDL_PathInfo info;
+        if (!SDL_GetPathInfo(stream, &info) && !Stream_Generate(stream, 64, 64, TILE_SIZE, (Uint32)SDL_GetTicks() | 1u))
+            SDL_Log("can't write world file %s", stream);
+        if (!Game_OpenWorld(&game, stream)) SDL_Log("world file %s not loaded, playing the arena", stream);
+    }
+    Game_SetView(&game, (float)WINDOW_W, (float)WINDOW_H);
+    if (stress) Game_SetMode(&game, MODE_STRESS);
+
+    // simulation runs on its own thread, this one pumps events and draws snapshots
+    static Sim sim;
+    if (!Sim_Start(&sim, &game)) {
+        Game_Shutdown(&game);
+        SDL_StopTextInput(window);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 4;
+    }
 
-    Uint64 last = SDL_GetPerformanceCounter();
     bool running = true;
 
     while (running) {
-        Uint64 now = SDL_GetPerformanceCounter();
-        float dt = (float)(now - last) / (float)SDL_GetPerformanceFrequency();
-        last = now;
-
         SDL_Event e;
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_EVENT_QUIT) running = false;
-            Game_HandleEvent(&game, &e);
+            // keeps the SDL timestamp, the sim applies it at that time
+            Sim_PushEvent(&sim, &e);
         }
 
-        const bool* keys = SDL_GetKeyboardState(NULL);
-        Game_Update(&game, keys, dt);
+        // next tick runs while this frame draws and waits on present
+        Sim_Kick(&sim);
 
         SDL_SetRenderDrawColor(renderer, 15, 15, 18, 255);
         SDL_RenderClear(renderer);
 
-        Game_Render(&game, renderer);
+        const GameView* view = Sim_Latest(&sim);
+        Game_Render(view, renderer);
 
         SDL_RenderPresent(renderer);
+        latency_sample(&latency, view);
     }
 
+    Sim_Stop(&sim);
+    Game_Shutdown(&game);
+
     SDL_StopTextInput(window);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -0,0 +1,756 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "scores.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* ------------------ table helpers ------------------ */
+
+static void trim_newline(char* s)
+{
+    size_t n = strlen(s);
+    while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r')) {
+        s[n - 1] = 0;
+        n--;
+    }
+}
+
+int Scores_Find(const ScoreEntry* s, int count, const char* name)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(s[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// keeps the table sorted (stable, higher first) and capped at SCORE_MAX
+int Scores_Merge(ScoreEntry* s, int count, const char* name, int kills)
+{
+    if (!name || name[0] == 0) return count;
+    if (kills < 0) kills = 0;
+
+    int idx = Scores_Find(s, count, name);
+    if (idx >= 0) {
+        if (kills <= s[idx].bestKills) return count;
+    }
+    else {
+        if (count < SCORE_MAX) idx = count++;
+        else {
+            // full, replace the lowest only if we beat it
+            idx = count - 1;
+            if (kills <= s[idx].bestKills) return count;
+        }
+        SDL_strlcpy(s[idx].name, name, NAME_MAX);
+    }
+
+    s[idx].bestKills = kills;
+
+    // bubble the updated entry up
+    while (idx > 0 && s[idx - 1].bestKills < s[idx].bestKills) {
+        ScoreEntry tmp = s[idx - 1];
+        s[idx - 1] = s[idx];
+        s[idx] = tmp;
+        idx--;
+    }
+    return count;
+}
+
+static int parse_scores(FILE* f, ScoreEntry* s)
+{
+    int count = 0;
+
+    char line[128];
+    while (fgets(line, (int)sizeof(line), f)) {
+        trim_newline(line);
+        if (line[0] == 0) continue;
+
+        // format: name,kills
+        char* comma = strchr(line, ',');
+        if (!comma) continue;
+        *comma = 0;
+
+        const char* name = line;
+        const char* killsStr = comma + 1;
+
+        if (name[0] == 0) continue;
+        count = Scores_Merge(s, count, name, atoi(killsStr));
+    }
+    return count;
+}
+
+/* ------------------ run histogram ------------------ */
+
+static int kill_bin(int kills)
+{
+    if (kills < 0) return 0;
+    if (kills >= KILL_BINS) return KILL_BINS - 1;
+    return kills;
+}
+
+void ScoreHist_Clear(ScoreHist* h)
+{
+    SDL_zerop(h);
+}
+
+void ScoreHist_Add(ScoreHist* h, int kills, int n)
+{
+    int b = kill_bin(kills);
+    h->count[b] += n;
+    h->total += n;
+    for (int i = b + 1; i <= KILL_BINS; i += i & -i)
+        h->tree[i] += n;
+}
+
+// runs with kills <= bin
+static int hist_prefix(const ScoreHist* h, int b)
+{
+    int sum = 0;
+    for (int i = b + 1; i > 0; i -= i & -i)
+        sum += h->tree[i];
+    return sum;
+}
+
+// O(n) rebuild after bulk loading count[]
+static void hist_build(ScoreHist* h)
+{
+    h->total = 0;
+    for (int i = 1; i <= KILL_BINS; i++) {
+        h->tree[i] = h->count[i - 1];
+        h->total += h->count[i - 1];
+    }
+    for (int i = 1; i <= KILL_BINS; i++) {
+        int up = i + (i & -i);
+        if (up <= KILL_BINS) h->tree[up] += h->tree[i];
+    }
+}
+
+// 1 + runs that did strictly better
+int ScoreHist_Rank(const ScoreHist* h, int kills)
+{
+    return 1 + h->total - hist_prefix(h, kill_bin(kills));
+}
+
+// "top N%", rounded up so the best run is top 1% not top 0%
+int ScoreHist_TopPercent(const ScoreHist* h, int kills)
+{
+    if (h->total <= 0) return 100;
+    long long rank = ScoreHist_Rank(h, kills);
+    int pct = (int)((rank * 100 + h->total - 1) / h->total);
+    return (pct > 100) ? 100 : pct;
+}
+
+/* ------------------ time windows ------------------ */
+
+static int days_from_civil(int y, int m, int d)
+{
+    y -= (m <= 2);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// local calendar day, so "today" flips at the cabinet's midnight
+int Scores_Today(void)
+{
+    SDL_Time now;
+    if (!SDL_GetCurrentTime(&now)) return 0;
+
+    SDL_DateTime dt;
+    if (!SDL_TimeToDateTime(now, &dt, true))
+        return (int)(now / SDL_NS_PER_SECOND / 86400);
+
+    return days_from_civil(dt.year, dt.month, dt.day);
+}
+
+static void board_clear(ScoreBoard* b)
+{
+    b->count = 0;
+    ScoreHist_Clear(&b->hist);
+}
+
+// week/today boards from the day buckets, O(SCORE_DAYS * KILL_BINS)
+static void rebuild_windows(ScoreState* s)
+{
+    ScoreBoard* wk = &s->boards[BOARD_WEEK];
+    ScoreBoard* td = &s->boards[BOARD_TODAY];
+    board_clear(wk);
+    board_clear(td);
+
+    for (int d = 0; d < SCORE_DAYS; d++) {
+        const ScoreDay* day = &s->days[d];
+        if (day->day == 0) continue;
+
+        for (int i = 0; i < day->count; i++)
+            wk->count = Scores_Merge(wk->top, wk->count, day->top[i].name, day->top[i].bestKills);
+        for (int i = 0; i < KILL_BINS; i++)
+            wk->hist.count[i] += day->runs[i];
+
+        if (day->day == s->today) {
+            SDL_memcpy(td->top, day->top, sizeof(day->top));
+            td->count = day->count;
+            SDL_memcpy(td->hist.count, day->runs, sizeof(day->runs));
+        }
+    }
+
+    hist_build(&wk->hist);
+    hist_build(&td->hist);
+}
+
+// rotate buckets forward to day, only the expiring buckets get touched
+void Scores_Advance(ScoreState* s, int day)
+{
+    if (day <= s->today) return;
+
+    int from = s->today + 1;
+    if (day - from >= SCORE_DAYS) from = day - SCORE_DAYS + 1;
+
+    ScoreBoard* wk = &s->boards[BOARD_WEEK];
+    bool expired = false;
+
+    for (int d = from; d <= day; d++) {
+        ScoreDay* slot = &s->days[d % SCORE_DAYS];
+        if (slot->day != 0) {
+            for (int i = 0; i < KILL_BINS; i++) {
+                if (slot->runs[i]) ScoreHist_Add(&wk->hist, i, -slot->runs[i]);
+            }
+            expired = true;
+        }
+        SDL_zerop(slot);
+        slot->day = d;
+    }
+
+    s->today = day;
+    board_clear(&s->boards[BOARD_TODAY]);
+
+    // week top can't be un-merged, redo it from the surviving day tops
+    if (expired) {
+        wk->count = 0;
+        for (int d = 0; d < SCORE_DAYS; d++) {
+            const ScoreDay* slot = &s->days[d];
+            for (int i = 0; i < slot->count; i++)
+                wk->count = Scores_Merge(wk->top, wk->count, slot->top[i].name, slot->top[i].bestKills);
+        }
+    }
+}
+
+// one run into every window, O(log KILL_BINS) + table inserts
+void Scores_Add(ScoreState* s, const char* name, int kills, int day)
+{
+    if (!name || name[0] == 0) return;
+    if (kills < 0) kills = 0;
+
+    ScoreBoard* all = &s->boards[BOARD_ALL];
+    all->count = Scores_Merge(all->top, all->count, name, kills);
+    ScoreHist_Add(&all->hist, kills, 1);
+
+    Scores_Advance(s, day);
+    if (day <= s->today - SCORE_DAYS) return;
+
+    // still in the week but without a bucket: nobody here played that day
+    // (a run queued before midnight and merged after it). the slot holds
+    // nothing or a day that's out of the week, either way it's this day's now
+    ScoreDay* slot = &s->days[day % SCORE_DAYS];
+    if (slot->day != day) {
+        bool stale = slot->day != 0;
+        SDL_zerop(slot);
+        slot->day = day;
+        if (stale) rebuild_windows(s);
+    }
+
+    slot->count = Scores_Merge(slot->top, slot->count, name, kills);
+    slot->runs[kill_bin(kills)]++;
+
+    ScoreBoard* wk = &s->boards[BOARD_WEEK];
+    wk->count = Scores_Merge(wk->top, wk->count, name, kills);
+    ScoreHist_Add(&wk->hist, kills, 1);
+
+    if (day == s->today) {
+        ScoreBoard* td = &s->boards[BOARD_TODAY];
+        td->count = Scores_Merge(td->top, td->count, name, kills);
+        ScoreHist_Add(&td->hist, kills, 1);
+    }
+}
+
+/* ------------------ score files ------------------ */
+
+// <path> holds everything, so one tmp write + rename per save changes the
+// table, the run history and the day buckets together:
+//   #mark scores 2
+//   T,<kills>,<name>    all-time table
+//   A,<kills>,<runs>    all-time run histogram
+//   D,<day>             a day bucket, followed by its
+//   S,<kills>,<name>    table and
+//   H,<kills>,<runs>    runs
+// older files are only name,kills lines, with the history in <path>.hist
+// (kills,runs) and the days in <path>.days. they're read until the next save
+#define SCORE_FILE_TAG "#mark scores 2"
+
+static void side_path(char* out, int outSize, const char* path, const char* ext)
+{
+    SDL_snprintf(out, outSize, "%s%s", path, ext);
+}
+
+// false = it's there but couldn't be opened (permissions, io, a flaky share).
+// only a file that doesn't exist reads as empty, *f = NULL
+static bool open_existing(const char* path, FILE** f)
+{
+    *f = fopen(path, "r");
+    return *f || errno == ENOENT;
+}
+
+// false when the read itself failed part way
+static bool close_read(FILE* f)
+{
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+// tagged lines, the all-time histogram only gets its counts filled in
+static void parse_state(FILE* f, ScoreState* s)
+{
+    ScoreBoard* all = &s->boards[BOARD_ALL];
+    ScoreDay* cur = NULL;
+
+    char line[128];
+    while (fgets(line, (int)sizeof(line), f)) {
+        trim_newline(line);
+        if (line[0] == 0 || line[1] != ',') continue;
+
+        char* rest = line + 2;
+        if (line[0] == 'D') {
+            int day = atoi(rest);
+            cur = NULL;
+            if (day <= 0) continue;
+
+            ScoreDay* slot = &s->days[day % SCORE_DAYS];
+            if (slot->day > day) continue;   // newer bucket already owns the slot
+            if (slot->day != day) {
+                SDL_zerop(slot);
+                slot->day = day;
+            }
+            if (day > s->today) s->today = day;
+            cur = slot;
+            continue;
+        }
+
+        char* comma = strchr(rest, ',');
+        if (!comma) continue;
+        int kills = atoi(rest);
+        int runs = atoi(comma + 1);
+
+        if (line[0] == 'T' && comma[1] != 0)
+            all->count = Scores_Merge(all->top, all->count, comma + 1, kills);
+        else if (line[0] == 'A' && runs > 0)
+            all->hist.count[kill_bin(kills)] += runs;
+        else if (cur && line[0] == 'S' && comma[1] != 0)
+            cur->count = Scores_Merge(cur->top, cur->count, comma + 1, kills);
+        else if (cur && line[0] == 'H' && runs > 0)
+            cur->runs[kill_bin(kills)] += runs;
+    }
+}
+
+// an untagged table, its history and days are still in the side files
+static bool load_legacy(const char* path, ScoreState* s)
+{
+    ScoreBoard* all = &s->boards[BOARD_ALL];
+    char side[300];
+    FILE* f;
+
+    side_path(side, (int)sizeof(side), path, ".hist");
+    if (!open_existing(side, &f)) return false;
+    if (f) {
+        char line[64];
+        while (fgets(line, (int)sizeof(line), f)) {
+            char* comma = strchr(line, ',');
+            if (!comma) continue;
+            int runs = atoi(comma + 1);
+            if (runs > 0) all->hist.count[kill_bin(atoi(line))] += runs;
+        }
+        if (!close_read(f)) return false;
+    }
+    else {
+        // older still, no history at all, seed it with the table
+        for (int i = 0; i < all->count; i++) all->hist.count[kill_bin(all->top[i].bestKills)]++;
+    }
+
+    side_path(side, (int)sizeof(side), path, ".days");
+    if (!open_existing(side, &f)) return false;
+    if (f) {
+        parse_state(f, s);
+        if (!close_read(f)) return false;
+    }
+    return true;
+}
+
+// caller holds the lock, or there is none to take
+static bool load_state(const char* path, ScoreState* s, int today)
+{
+    SDL_zerop(s);
+
+    ScoreBoard* all = &s->boards[BOARD_ALL];
+    FILE* f;
+    if (!open_existing(path, &f)) return false;
+
+    bool legacy = true;
+    if (f) {
+        char line[128];
+        if (fgets(line, (int)sizeof(line), f)) {
+            trim_newline(line);
+            legacy = strcmp(line, SCORE_FILE_TAG) != 0;
+        }
+        if (legacy) {
+            rewind(f);
+            all->count = parse_scores(f, all->top);
+        }
+        else {
+            parse_state(f, s);
+        }
+        if (!close_read(f)) return false;
+    }
+    if (legacy && !load_legacy(path, s)) return false;
+
+    // drop buckets that fell out of the week relative to the newest one.
+    // bounded to SCORE_DAYS buckets, startup cost doesn't grow with history
+    for (int d = 0; d < SCORE_DAYS; d++) {
+        if (s->days[d].day != 0 && s->days[d].day <= s->today - SCORE_DAYS)
+            SDL_zerop(&s->days[d]);
+    }
+
+    hist_build(&all->hist);
+    rebuild_windows(s);
+    Scores_Advance(s, today);
+    return true;
+}
+
+static bool close_synced(FILE* f)
+{
+    bool ok = (fflush(f) == 0);
+#ifndef _WIN32
+    if (ok) fsync(fileno(f));
+#endif
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+static bool write_state(const char* path, const ScoreState* s)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+
+    fprintf(f, "%s\n", SCORE_FILE_TAG);
+
+    const ScoreBoard* all = &s->boards[BOARD_ALL];
+    for (int i = 0; i < all->count; i++)
+        fprintf(f, "T,%d,%s\n", all->top[i].bestKills, all->top[i].name);
+    for (int i = 0; i < KILL_BINS; i++) {
+        if (all->hist.count[i] > 0) fprintf(f, "A,%d,%d\n", i, all->hist.count[i]);
+    }
+
+    for (int d = 0; d < SCORE_DAYS; d++) {
+        const ScoreDay* day = &s->days[d];
+        if (day->day == 0 || day->count == 0) continue;
+
+        fprintf(f, "D,%d\n", day->day);
+        for (int i = 0; i < day->count; i++)
+            fprintf(f, "S,%d,%s\n", day->top[i].bestKills, day->top[i].name);
+        for (int i = 0; i < KILL_BINS; i++) {
+            if (day->runs[i] > 0) fprintf(f, "H,%d,%d\n", i, day->runs[i]);
+        }
+    }
+    return close_synced(f);
+}
+
+// write to <path>.tmp and rename over, a reader (or a save that failed half
+// way) only ever sees the whole old state or the whole new one
+static bool replace_file(const char* path, const ScoreState* s)
+{
+    char tmp[310];
+    SDL_snprintf(tmp, (int)sizeof(tmp), "%s.tmp", path);
+    if (!write_state(tmp, s) || !SDL_RenamePath(tmp, path)) return false;
+
+    // the side files of an older table are in this one now
+    char side[300];
+    side_path(side, (int)sizeof(side), path, ".hist");
+    SDL_RemovePath(side);
+    side_path(side, (int)sizeof(side), path, ".days");
+    SDL_RemovePath(side);
+    return true;
+}
+
+/* ------------------ advisory file lock ------------------ */
+
+// lock lives in a separate "<path>.lock" file so the rename of the
+// score file itself never invalidates it
+
+#ifdef _WIN32
+typedef HANDLE LockHandle;
+#define LOCK_NONE INVALID_HANDLE_VALUE
+
+static LockHandle lock_file(const char* lockPath)
+{
+    HANDLE h = CreateFileA(lockPath, GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return LOCK_NONE;
+
+    OVERLAPPED ov = { 0 };
+    if (!LockFileEx(h, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &ov)) {
+        CloseHandle(h);
+        return LOCK_NONE;
+    }
+    return h;
+}
+
+static void unlock_file(LockHandle h)
+{
+    OVERLAPPED ov = { 0 };
+    UnlockFileEx(h, 0, 1, 0, &ov);
+    CloseHandle(h);
+}
+#else
+typedef int LockHandle;
+#define LOCK_NONE (-1)
+
+static LockHandle lock_file(const char* lockPath)
+{
+    int fd = open(lockPath, O_RDWR | O_CREAT, 0666);
+    if (fd < 0) return LOCK_NONE;
+
+    // fcntl locks also work over NFS, flock does not everywhere
+    struct flock fl = { 0 };
+    fl.l_type = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    while (fcntl(fd, F_SETLKW, &fl) != 0) {
+        if (errno != EINTR) {
+            close(fd);
+            return LOCK_NONE;
+        }
+    }
+    return fd;
+}
+
+static void unlock_file(LockHandle fd)
+{
+    struct flock fl = { 0 };
+    fl.l_type = F_UNLCK;
+    fl.l_whence = SEEK_SET;
+    fcntl(fd, F_SETLK, &fl);
+    close(fd);
+}
+#endif
+
+bool Scores_Load(const char* path, ScoreState* s, int today)
+{
+    char lockPath[300];
+    side_path(lockPath, (int)sizeof(lockPath), path, ".lock");
+
+    // an open file can't be renamed over on windows, a reader holding it
+    // would fail a writer's save. read-only dir = no lock, read it as it is
+    LockHandle lk = lock_file(lockPath);
+    bool ok = load_state(path, s, today);
+    if (lk != LOCK_NONE) unlock_file(lk);
+    return ok;
+}
+
+// lock, take the latest state from disk, merge our runs in, write it atomically
+static bool submit_locked(const char* path, const ScoreRun* runs, int runCount, ScoreState* out)
+{
+    char lockPath[300];
+    side_path(lockPath, (int)sizeof(lockPath), path, ".lock");
+
+    LockHandle lk = lock_file(lockPath);
+    if (lk == LOCK_NONE) return false;
+
+    // only file io under the lock. a table we couldn't read would come back
+    // empty, writing that over it would wipe everyone else's scores
+    if (!load_state(path, out, Scores_Today())) {
+        unlock_file(lk);
+        return false;
+    }
+    for (int i = 0; i < runCount; i++) {
+        Scores_Add(out, runs[i].name, runs[i].kills, runs[i].day);
+    }
+
+    bool ok = replace_file(path, out);
+
+    unlock_file(lk);
+    return ok;
+}
+
+/* ------------------ background writer ------------------ */
+
+// failed runs go back in front of whatever was queued meanwhile
+static void requeue(ScoreSync* s, const ScoreRun* runs, int n)
+{
+    int keep = SDL_min(s->pendingCount, SCORE_PENDING - n);
+    if (keep < s->pendingCount) SDL_Log("score queue full, dropping %d runs", s->pendingCount - keep);
+
+    SDL_memmove(s->pending + n, s->pending, sizeof(ScoreRun) * (size_t)keep);
+    SDL_memcpy(s->pending, runs, sizeof(ScoreRun) * (size_t)n);
+    s->pendingCount = n + keep;
+}
+
+// waits out the backoff, new runs don't cut it short. once quitting it's capped
+// so shutdown doesn't hang on a dead share
+static void backoff(ScoreSync* s, Uint32 ms)
+{
+    Uint64 start = SDL_GetTicks();
+    Uint64 until = start + ms;
+    for (Uint64 now = start; now < until; now = SDL_GetTicks()) {
+        if (s->quit) until = SDL_min(until, start + SCORE_RETRY_MS);
+        SDL_WaitConditionTimeout(s->cond, s->mutex, (Sint32)(until - now));
+    }
+}
+
+static int SDLCALL score_worker(void* data)
+{
+    ScoreSync* s = (ScoreSync*)data;
+
+    ScoreRun batch[SCORE_PENDING];
+    ScoreState* state = (ScoreState*)SDL_malloc(sizeof(ScoreState));
+    Uint32 retryMs = 0;
+    int quitTries = 0;
+
+    SDL_LockMutex(s->mutex);
+    for (;;) {
+        while (s->pendingCount == 0 && !s->quit)
+            SDL_WaitCondition(s->cond, s->mutex);
+
+        if (s->pendingCount == 0 && s->quit) break;
+        if (retryMs) backoff(s, retryMs);
+
+        int n = s->pendingCount;
+        SDL_memcpy(batch, s->pending, sizeof(ScoreRun) * (size_t)n);
+        s->pendingCount = 0;
+        SDL_UnlockMutex(s->mutex);
+
+        bool ok = state && submit_locked(s->path, batch, n, state);
+
+        SDL_LockMutex(s->mutex);
+        if (ok) {
+            SDL_memcpy(s->merged, state, sizeof(ScoreState));
+            s->mergedReady = true;
+            retryMs = 0;
+            continue;
+        }
+
+        requeue(s, batch, n);
+        if (s->quit && ++quitTries >= SCORE_QUIT_TRIES) {
+            SDL_Log("score save failed (%s), dropping %d runs", s->path, s->pendingCount);
+            break;
+        }
+        retryMs = retryMs ? SDL_min(retryMs * 2, SCORE_RETRY_MAX_MS) : SCORE_RETRY_MS;
+        SDL_Log("score save failed (%s), trying again in %u ms", s->path, (unsigned)retryMs);
+    }
+    SDL_UnlockMutex(s->mutex);
+
+    SDL_free(state);
+    return 0;
+}
+
+void ScoreSync_Start(ScoreSync* s, const char* path)
+{
+    SDL_zerop(s);
+    SDL_strlcpy(s->path, path, sizeof(s->path));
+
+    s->merged = (ScoreState*)SDL_malloc(sizeof(ScoreState));
+    if (!s->merged) return;
+
+    s->mutex = SDL_CreateMutex();
+    s->cond = SDL_CreateCondition();
+    if (s->mutex && s->cond)
+        s->thread = SDL_CreateThread(score_worker, "mark_scores", s);
+
+    if (!s->thread) SDL_Log("score writer thread failed, saving inline: %s", SDL_GetError());
+}
+
+void ScoreSync_Submit(ScoreSync* s, const char* name, int kills, int day)
+{
+    if (!name || name[0] == 0 || !s->merged) return;
+
+    ScoreRun run = { 0 };
+    SDL_strlcpy(run.name, name, NAME_MAX);
+    run.kills = kills;
+    run.day = day;
+
+    if (!s->thread) {
+        // no worker, do it here. a failed save stays queued for the next one
+        if (s->pendingCount < SCORE_PENDING)
+            s->pending[s->pendingCount++] = run;
+        else
+            SDL_Log("score queue full, dropping %s,%d", name, kills);
+
+        s->mergedReady = submit_locked(s->path, s->pending, s->pendingCount, s->merged);
+        if (s->mergedReady) s->pendingCount = 0;
+        else SDL_Log("score save failed (%s), %d runs kept for the next save", s->path, s->pendingCount);
+        return;
+    }
+
+    SDL_LockMutex(s->mutex);
+    if (s->pendingCount < SCORE_PENDING)
+        s->pending[s->pendingCount++] = run;
+    else
+        SDL_Log("score queue full, dropping %s,%d", name, kills);
+    SDL_SignalCondition(s->cond);
+    SDL_UnlockMutex(s->mutex);
+}
+
+// never blocks, if the worker is busy we just try again next frame
+bool ScoreSync_Poll(ScoreSync* s, ScoreState* out)
+{
+    if (!s->merged) return false;
+    if (s->thread && !SDL_TryLockMutex(s->mutex)) return false;
+
+    bool got = s->mergedReady;
+    if (got) {
+        SDL_memcpy(out, s->merged, sizeof(ScoreState));
+
+        // anything queued after that merge started isn't on disk yet
+        for (int i = 0; i < s->pendingCount; i++)
+            Scores_Add(out, s->pending[i].name, s->pending[i].kills, s->pending[i].day);
+
+        s->mergedReady = false;
+    }
+
+    if (s->thread) SDL_UnlockMutex(s->mutex);
+    return got;
+}
+
+// flushes whatever is still queued
+void ScoreSync_Stop(ScoreSync* s)
+{
+    if (s->thread) {
+        SDL_LockMutex(s->mutex);
+        s->quit = true;
+        SDL_SignalCondition(s->cond);
+        SDL_UnlockMutex(s->mutex);
+
+        SDL_WaitThread(s->thread, NULL);
+        s->thread = NULL;
+    }
+    else if (s->merged && s->pendingCount > 0 &&
+             !submit_locked(s->path, s->pending, s->pendingCount, s->merged)) {
+        SDL_Log("score save failed (%s), dropping %d runs", s->path, s->pendingCount);
+    }
+
+    if (s->cond) SDL_DestroyCondition(s->cond);
+    if (s->mutex) SDL_DestroyMutex(s->mutex);
+    SDL_free(s->merged);
+    s->cond = NULL;
+    s->mutex = NULL;
+    s->merged = NULL;
+}
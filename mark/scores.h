@@ -0,0 +1,98 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+#define NAME_MAX      16
+#define SCORE_MAX     32
+#define SCORE_PENDING 64
+#define SCORE_RETRY_MS     250   // first wait after a failed save, doubles each time
+#define SCORE_RETRY_MAX_MS 8000
+#define SCORE_QUIT_TRIES   5     // saves tried while shutting down before runs are dropped
+#define SCORE_DAYS    7      // rolling week = 7 day buckets
+#define KILL_BINS     2048   // kill counts above this share the last bin
+
+typedef struct {
+    char name[NAME_MAX];
+    int bestKills;
+} ScoreEntry;
+
+// run distribution, fenwick tree over kill counts
+// rank/percentile are O(log KILL_BINS) no matter how many runs are recorded
+typedef struct {
+    int count[KILL_BINS];    // runs per kill count
+    int tree[KILL_BINS + 1]; // 1-based fenwick over count
+    int total;
+} ScoreHist;
+
+typedef enum {
+    BOARD_ALL = 0,
+    BOARD_WEEK = 1,
+    BOARD_TODAY = 2,
+    BOARD_COUNT
+} ScoreWindow;
+
+typedef struct {
+    ScoreEntry top[SCORE_MAX];
+    int count;
+    ScoreHist hist;
+} ScoreBoard;
+
+// one day of runs, the week board is the sum of the live buckets
+typedef struct {
+    int day;                 // local days since 1970, 0 = empty
+    ScoreEntry top[SCORE_MAX];
+    int count;
+    int runs[KILL_BINS];
+} ScoreDay;
+
+typedef struct {
+    ScoreBoard boards[BOARD_COUNT];
+    ScoreDay days[SCORE_DAYS];   // ring, slot = day % SCORE_DAYS
+    int today;
+} ScoreState;
+
+typedef struct {
+    char name[NAME_MAX];
+    int kills;
+    int day;
+} ScoreRun;
+
+// background score writer
+// submit only queues, worker does lock -> reread -> merge -> tmp write -> rename -> unlock.
+// a failed save (lock, unreadable file, write, rename) keeps its runs queued and
+// is tried again with a backoff
+typedef struct {
+    char path[256];
+
+    SDL_Thread* thread;
+    SDL_Mutex* mutex;
+    SDL_Condition* cond;
+    bool quit;
+
+    ScoreRun pending[SCORE_PENDING];
+    int pendingCount;
+
+    // latest on-disk state after a merge (picked up with ScoreSync_Poll)
+    ScoreState* merged;
+    bool mergedReady;
+} ScoreSync;
+
+int  Scores_Find(const ScoreEntry* s, int count, const char* name);
+int  Scores_Merge(ScoreEntry* s, int count, const char* name, int kills);
+
+int  Scores_Today(void);
+// a missing file is an empty board, false = it's there but couldn't be read.
+// takes the writers' lock while it reads
+bool Scores_Load(const char* path, ScoreState* s, int today);
+void Scores_Add(ScoreState* s, const char* name, int kills, int day);
+void Scores_Advance(ScoreState* s, int day);
+
+void ScoreHist_Clear(ScoreHist* h);
+void ScoreHist_Add(ScoreHist* h, int kills, int n);
+int  ScoreHist_Rank(const ScoreHist* h, int kills);
+int  ScoreHist_TopPercent(const ScoreHist* h, int kills);
+
+void ScoreSync_Start(ScoreSync* s, const char* path);
+void ScoreSync_Submit(ScoreSync* s, const char* name, int kills, int day);
+bool ScoreSync_Poll(ScoreSync* s, ScoreState* out);
+void ScoreSync_Stop(ScoreSync* s);
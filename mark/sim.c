@@ -0,0 +1,160 @@
+#include "sim.h"
+
+// presses/releases change what a tick does, so the tick is split at them
+// motion and key repeats just update the state
+static bool is_action(const SDL_Event* e)
+{
+    switch (e->type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        return !e->key.repeat;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void apply_event(GameInput* in, const SDL_Event* e)
+{
+    switch (e->type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        if (e->key.scancode < SDL_SCANCODE_COUNT)
+            in->keys[e->key.scancode] = e->key.down;
+        break;
+
+    case SDL_EVENT_MOUSE_MOTION:
+        in->mouseX = e->motion.x;
+        in->mouseY = e->motion.y;
+        in->mouse = e->motion.state;
+        break;
+
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        in->mouseX = e->button.x;
+        in->mouseY = e->button.y;
+        if (e->button.down) in->mouse |= SDL_BUTTON_MASK(e->button.button);
+        else                in->mouse &= ~SDL_BUTTON_MASK(e->button.button);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void advance(Sim* s, Uint64 to)
+{
+    if (to <= s->simTime) return;
+    Game_Update(s->game, &s->input, (float)(to - s->simTime) / 1e9f);
+    s->simTime = to;
+}
+
+// runs the game up to 'now', splitting the step at every action event
+// so a click lands on the tick it happened in, not the next frame
+static void sim_tick(Sim* s, Uint64 now)
+{
+    InputEvent* ev;
+    while ((ev = Input_Peek(&s->queue)) != NULL) {
+        const SDL_Event* e = &ev->e;
+        if (e->common.timestamp > now) break;   // belongs to the next tick
+
+        if (is_action(e)) {
+            advance(s, e->common.timestamp);
+            s->actionTs = e->common.timestamp;
+            s->actionApplied = SDL_GetTicksNS();
+        }
+
+        apply_event(&s->input, e);
+        Game_HandleEvent(s->game, e);
+        Input_Pop(&s->queue);
+    }
+
+    advance(s, now);
+}
+
+static int SDLCALL sim_thread(void* data)
+{
+    Sim* s = (Sim*)data;
+
+    for (;;) {
+        SDL_WaitSemaphore(s->kick);
+        // render got ahead, do one longer tick instead of a backlog
+        while (SDL_TryWaitSemaphore(s->kick)) {}
+        if (SDL_GetAtomicInt(&s->quit)) break;
+
+        sim_tick(s, SDL_GetTicksNS());
+
+        GameView* v = (GameView*)Snap_Back(&s->snap);
+        Game_Snapshot(s->game, v);
+        v->inputTs = s->actionTs;
+        v->inputApplied = s->actionApplied;
+        Snap_Publish(&s->snap);
+    }
+    return 0;
+}
+
+bool Sim_Start(Sim* s, Game* g)
+{
+    SDL_zerop(s);
+    s->game = g;
+    s->simTime = SDL_GetTicksNS();
+    Input_Init(&s->queue);
+
+    // front slot holds the state before the first tick
+    Snap_Init(&s->snap, &s->views[0], &s->views[1], &s->views[2]);
+    Game_Snapshot(g, &s->views[0]);
+
+    s->kick = SDL_CreateSemaphore(0);
+    if (s->kick)
+        s->thread = SDL_CreateThread(sim_thread, "mark_sim", s);
+
+    if (!s->thread) {
+        SDL_Log("sim thread failed: %s", SDL_GetError());
+        Sim_Stop(s);
+        return false;
+    }
+    return true;
+}
+
+void Sim_PushEvent(Sim* s, const SDL_Event* e)
+{
+    switch (e->type) {
+    case SDL_EVENT_TEXT_INPUT:
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+    case SDL_EVENT_MOUSE_MOTION:
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        Input_Push(&s->queue, e);
+        break;
+    default:
+        break;
+    }
+}
+
+void Sim_Kick(Sim* s)
+{
+    SDL_SignalSemaphore(s->kick);
+}
+
+const GameView* Sim_Latest(Sim* s)
+{
+    return (const GameView*)Snap_Latest(&s->snap);
+}
+
+void Sim_Stop(Sim* s)
+{
+    if (s->thread) {
+        SDL_SetAtomicInt(&s->quit, 1);
+        SDL_SignalSemaphore(s->kick);
+        SDL_WaitThread(s->thread, NULL);
+        s->thread = NULL;
+    }
+
+    if (s->kick) SDL_DestroySemaphore(s->kick);
+    s->kick = NULL;
+
+    for (int i = 0; i < 3; i++) GameView_Free(&s->views[i]);
+}
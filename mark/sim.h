@@ -0,0 +1,34 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+#include "game.h"
+#include "input.h"
+#include "snap.h"
+
+// runs Game_Update on its own thread, main thread only pumps events and draws
+// each kick simulates frame N+1 while the main thread presents frame N
+typedef struct {
+    Game* game;
+    SDL_Thread* thread;
+    SDL_Semaphore* kick;    // one post per rendered frame
+    SDL_AtomicInt quit;
+
+    // timestamped events from the main thread
+    InputQueue queue;
+
+    // sim thread only
+    GameInput input;        // key/mouse state rebuilt from the events
+    Uint64 simTime;         // ns, how far the game has been simulated
+    Uint64 actionTs;        // newest fire/dash/reload style event applied
+    Uint64 actionApplied;   // when it was applied
+
+    GameView views[3];
+    SnapBuffer snap;
+} Sim;
+
+bool Sim_Start(Sim* s, Game* g);
+void Sim_PushEvent(Sim* s, const SDL_Event* e);
+void Sim_Kick(Sim* s);
+const GameView* Sim_Latest(Sim* s);
+void Sim_Stop(Sim* s);
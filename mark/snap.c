@@ -0,0 +1,35 @@
+#include "snap.h"
+
+#define SNAP_FRESH 4
+
+// slot a starts as the front, so the reader has something before the first publish
+void Snap_Init(SnapBuffer* s, void* a, void* b, void* c)
+{
+    s->slots[0] = a;
+    s->slots[1] = b;
+    s->slots[2] = c;
+    s->front = 0;
+    s->back = 1;
+    SDL_SetAtomicInt(&s->ready, 2);
+}
+
+void* Snap_Back(SnapBuffer* s)
+{
+    return s->slots[s->back];
+}
+
+void Snap_Publish(SnapBuffer* s)
+{
+    // hand the filled slot over and take whatever was waiting (stale or not)
+    int old = SDL_SetAtomicInt(&s->ready, s->back | SNAP_FRESH);
+    s->back = old & 3;
+}
+
+void* Snap_Latest(SnapBuffer* s)
+{
+    if (SDL_GetAtomicInt(&s->ready) & SNAP_FRESH) {
+        int old = SDL_SetAtomicInt(&s->ready, s->front);
+        s->front = old & 3;
+    }
+    return s->slots[s->front];
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+// triple buffer, one writer (sim) and one reader (render), neither ever waits
+// writer fills Snap_Back and publishes, reader always gets the newest published slot
+typedef struct {
+    void* slots[3];
+    int back;               // writer owned
+    int front;              // reader owned
+    SDL_AtomicInt ready;    // last published slot, SNAP_FRESH set until the reader takes it
+} SnapBuffer;
+
+void  Snap_Init(SnapBuffer* s, void* a, void* b, void* c);
+void* Snap_Back(SnapBuffer* s);
+void  Snap_Publish(SnapBuffer* s);
+void* Snap_Latest(SnapBuffer* s);
@@ -0,0 +1,466 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "stream.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define CT STREAM_CHUNK_TILES
+
+/* ------------------ mapping ------------------ */
+
+// the handles can go right after, the view keeps the file open
+static const Uint8* map_file(const char* path, size_t* size)
+{
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER len;
+    HANDLE m = NULL;
+    void* p = NULL;
+    if (GetFileSizeEx(f, &len) && len.QuadPart > 0) {
+        m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m) p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (m) CloseHandle(m);
+    CloseHandle(f);
+    if (p) *size = (size_t)len.QuadPart;
+    return (const Uint8*)p;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+    *size = (size_t)st.st_size;
+    return (const Uint8*)p;
+#endif
+}
+
+static void unmap_file(const Uint8* p, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(p);
+#else
+    munmap((void*)p, size);
+#endif
+}
+
+/* ------------------ loader ------------------ */
+
+// copies one chunk out of the mapping, a bad entry loads as open ground
+static void load_chunk(const WorldStream* s, ChunkSlot* slot)
+{
+    const WorldChunk* e = (const WorldChunk*)(s->base + sizeof(WorldHeader)) +
+                          slot->cy * s->chunksX + slot->cx;
+    Uint32 n = SDL_min(e->spawners, (Uint32)STREAM_MAX_SPAWNERS);
+    Uint64 need = sizeof(slot->tiles) + (Uint64)n * sizeof(WorldSpawner);
+
+    // offset + need could wrap for a corrupt offset, compare against what's left
+    slot->spawnerCount = 0;
+    if (e->offset < sizeof(WorldHeader) || e->offset > (Uint64)s->size ||
+        need > (Uint64)s->size - e->offset) {
+        SDL_memset(slot->tiles, 0, sizeof(slot->tiles));
+        return;
+    }
+
+    const Uint8* p = s->base + e->offset;
+    SDL_memcpy(slot->tiles, p, sizeof(slot->tiles));
+    p += sizeof(slot->tiles);
+
+    float x0 = (float)slot->cx * s->chunkPx;
+    float y0 = (float)slot->cy * s->chunkPx;
+    for (Uint32 i = 0; i < n; i++, p += sizeof(WorldSpawner)) {
+        WorldSpawner w;
+        SDL_memcpy(&w, p, sizeof(w));
+        if (w.count == 0) continue;
+
+        ChunkSpawner* sp = &slot->spawners[slot->spawnerCount++];
+        sp->x = x0 + (float)w.x;
+        sp->y = y0 + (float)w.y;
+        sp->type = w.type;
+        sp->left = w.count;
+        sp->interval = (float)w.interval / 1000.0f;
+        sp->timer = sp->interval;
+    }
+}
+
+static int SDLCALL stream_loader(void* data)
+{
+    WorldStream* s = (WorldStream*)data;
+    int batch[STREAM_SLOTS];
+
+    SDL_LockMutex(s->mutex);
+    for (;;) {
+        while (s->queueCount == 0 && !s->quit)
+            SDL_WaitCondition(s->cond, s->mutex);
+        if (s->quit) break;
+
+        int n = s->queueCount;
+        SDL_memcpy(batch, s->queue, sizeof(int) * (size_t)n);
+        s->queueCount = 0;
+        SDL_UnlockMutex(s->mutex);
+
+        // queued nearest first, the window's own chunks lead
+        for (int i = 0; i < n; i++) {
+            ChunkSlot* slot = &s->slots[batch[i]];
+            load_chunk(s, slot);
+            SDL_SetAtomicInt(&slot->ready, 1);
+        }
+
+        SDL_LockMutex(s->mutex);
+        s->loads += n;
+    }
+    SDL_UnlockMutex(s->mutex);
+    return 0;
+}
+
+bool Stream_Open(WorldStream* s, const char* path)
+{
+    SDL_zerop(s);
+    s->base = map_file(path, &s->size);
+    if (!s->base) return false;
+
+    WorldHeader h;
+    bool ok = s->size >= sizeof(h);
+    if (ok) {
+        SDL_memcpy(&h, s->base, sizeof(h));
+        ok = h.magic == WORLD_MAGIC && h.version == WORLD_VERSION && h.chunkTiles == CT &&
+             h.chunksX > 0 && h.chunksY > 0 && h.chunksX <= STREAM_MAX_CHUNKS &&
+             h.chunksY <= STREAM_MAX_CHUNKS && h.tile > 0.0f &&
+             (Uint64)s->size >= sizeof(h) + sizeof(WorldChunk) * (Uint64)h.chunksX * h.chunksY;
+        if (h.magic == WORLD_MAGIC && h.version != WORLD_VERSION)
+            SDL_Log("world file %s is version %u, this build reads %u, delete it to get a new one",
+                    path, h.version, WORLD_VERSION);
+    }
+    s->slots = ok ? (ChunkSlot*)SDL_calloc(STREAM_SLOTS, sizeof(ChunkSlot)) : NULL;
+    if (!s->slots) {
+        SDL_Log("not a world file: %s", path);
+        unmap_file(s->base, s->size);
+        SDL_zerop(s);
+        return false;
+    }
+
+    s->chunksX = (int)h.chunksX;
+    s->chunksY = (int)h.chunksY;
+    s->tile = h.tile;
+    s->chunkPx = h.tile * CT;
+    for (int i = 0; i < STREAM_SLOTS; i++) s->slots[i].cx = -1;
+    for (int k = 0; k < STREAM_ACTIVE * STREAM_ACTIVE; k++) s->active[k] = -1;
+    s->winX = s->winY = -1;
+    s->wantX = s->wantY = -1;
+
+    s->mutex = SDL_CreateMutex();
+    s->cond = SDL_CreateCondition();
+    if (s->mutex && s->cond)
+        s->thread = SDL_CreateThread(stream_loader, "mark_stream", s);
+    if (!s->thread) SDL_Log("stream loader thread failed, loading inline: %s", SDL_GetError());
+    return true;
+}
+
+void Stream_Close(WorldStream* s)
+{
+    if (s->thread) {
+        SDL_LockMutex(s->mutex);
+        s->quit = true;
+        SDL_SignalCondition(s->cond);
+        SDL_UnlockMutex(s->mutex);
+
+        SDL_WaitThread(s->thread, NULL);
+    }
+    if (s->cond) SDL_DestroyCondition(s->cond);
+    if (s->mutex) SDL_DestroyMutex(s->mutex);
+    if (s->base) unmap_file(s->base, s->size);
+    SDL_free(s->slots);
+    SDL_zerop(s);
+}
+
+/* ------------------ resident set ------------------ */
+
+static int chunk_of(float v, float chunkPx, int chunks)
+{
+    return SDL_clamp((int)(v / chunkPx), 0, chunks - 1);
+}
+
+// top-left chunk of the window centred on chunk (cx, cy), held inside the world
+static void window_at(const WorldStream* s, int cx, int cy, int* wx, int* wy)
+{
+    *wx = SDL_clamp(cx - STREAM_ACTIVE / 2, 0, SDL_max(s->chunksX - STREAM_ACTIVE, 0));
+    *wy = SDL_clamp(cy - STREAM_ACTIVE / 2, 0, SDL_max(s->chunksY - STREAM_ACTIVE, 0));
+}
+
+static int find_slot(const WorldStream* s, int cx, int cy)
+{
+    for (int i = 0; i < STREAM_SLOTS; i++)
+        if (s->slots[i].cx == cx && s->slots[i].cy == cy) return i;
+    return -1;
+}
+
+// chunk (cx, cy) resident or on its way. a new one takes the slot unused
+// the longest that isn't wanted this update or still loading.
+// false when there's none, it gets another go next update
+static bool want_chunk(WorldStream* s, int cx, int cy, int* batch, int* n)
+{
+    if (cx < 0 || cy < 0 || cx >= s->chunksX || cy >= s->chunksY) return true;
+
+    int i = find_slot(s, cx, cy);
+    if (i >= 0) {
+        s->slots[i].used = s->tick;
+        return true;
+    }
+
+    int pick = -1;
+    for (int k = 0; k < STREAM_SLOTS; k++) {
+        ChunkSlot* c = &s->slots[k];
+        if (c->used == s->tick) continue;
+        if (c->queued && !SDL_GetAtomicInt(&c->ready)) continue;
+        if (pick < 0 || c->used < s->slots[pick].used) pick = k;
+    }
+    if (pick < 0) return false;
+
+    ChunkSlot* c = &s->slots[pick];
+    c->cx = cx;
+    c->cy = cy;
+    c->used = s->tick;
+    c->queued = true;
+    SDL_SetAtomicInt(&c->ready, 0);
+    batch[(*n)++] = pick;
+    return true;
+}
+
+// the window first, then what the player is heading into, then the ring
+static void prefetch(WorldStream* s, int cx, int cy, int acx, int acy)
+{
+    int batch[STREAM_SLOTS];
+    int n = 0;
+    bool ok = true;
+
+    int wx, wy;
+    window_at(s, cx, cy, &wx, &wy);
+    for (int j = 0; j < STREAM_ACTIVE; j++)
+        for (int i = 0; i < STREAM_ACTIVE; i++) ok &= want_chunk(s, wx + i, wy + j, batch, &n);
+    for (int j = -1; j <= 1; j++)
+        for (int i = -1; i <= 1; i++) ok &= want_chunk(s, acx + i, acy + j, batch, &n);
+    for (int j = -STREAM_RING / 2; j <= STREAM_RING / 2; j++)
+        for (int i = -STREAM_RING / 2; i <= STREAM_RING / 2; i++) ok &= want_chunk(s, cx + i, cy + j, batch, &n);
+
+    s->wantX = cx;
+    s->wantY = cy;
+    s->aheadX = acx;
+    s->aheadY = acy;
+    s->missed = !ok;
+    if (n == 0) return;
+
+    if (!s->thread) {
+        // no loader, do it here
+        for (int k = 0; k < n; k++) {
+            load_chunk(s, &s->slots[batch[k]]);
+            SDL_SetAtomicInt(&s->slots[batch[k]].ready, 1);
+        }
+        s->loads += n;
+        return;
+    }
+
+    SDL_LockMutex(s->mutex);
+    for (int k = 0; k < n && s->queueCount < STREAM_SLOTS; k++) s->queue[s->queueCount++] = batch[k];
+    SDL_SignalCondition(s->cond);
+    SDL_UnlockMutex(s->mutex);
+}
+
+/* ------------------ active window ------------------ */
+
+// every chunk of the window at (wx, wy) is ready, copy it into the tile map.
+// one tile wider than the chunks, same grid as the flow field over the area
+static void copy_window(WorldStream* s, int wx, int wy, TileMap* t)
+{
+    int cols = STREAM_ACTIVE * CT + 1;
+    if (!t->solid || t->cols != cols || t->rows != cols) {
+        Tiles_Free(t);
+        t->solid = (Uint8*)SDL_calloc((size_t)(cols * cols), 1);
+        if (!t->solid) return;
+        t->cols = t->rows = cols;
+    }
+    SDL_memset(t->solid, 0, (size_t)(cols * cols));
+
+    int walls = 0;
+    for (int j = 0; j < STREAM_ACTIVE; j++) {
+        for (int i = 0; i < STREAM_ACTIVE; i++) {
+            int k = j * STREAM_ACTIVE + i;
+            int cx = wx + i, cy = wy + j;
+            s->active[k] = -1;
+            if (cx >= s->chunksX || cy >= s->chunksY) continue;
+
+            int slot = find_slot(s, cx, cy);
+            ChunkSlot* c = &s->slots[slot];
+            c->queued = false;
+            s->active[k] = slot;
+
+            for (int r = 0; r < CT; r++) {
+                Uint8* dst = t->solid + (j * CT + r) * cols + i * CT;
+                const Uint8* src = c->tiles + r * CT;
+                for (int q = 0; q < CT; q++) {
+                    dst[q] = src[q] != 0;
+                    walls += dst[q];
+                }
+            }
+        }
+    }
+
+    t->tile = s->tile;
+    t->ox = (float)wx * s->chunkPx;
+    t->oy = (float)wy * s->chunkPx;
+    t->walls = walls;
+    s->winX = wx;
+    s->winY = wy;
+}
+
+bool Stream_Update(WorldStream* s, float x, float y, float ax, float ay, TileMap* tiles)
+{
+    s->tick++;
+
+    // the live window's slots hold its spawners, they stay
+    for (int k = 0; k < STREAM_ACTIVE * STREAM_ACTIVE; k++)
+        if (s->active[k] >= 0) s->slots[s->active[k]].used = s->tick;
+
+    int cx = chunk_of(x, s->chunkPx, s->chunksX), cy = chunk_of(y, s->chunkPx, s->chunksY);
+    int acx = chunk_of(ax, s->chunkPx, s->chunksX), acy = chunk_of(ay, s->chunkPx, s->chunksY);
+    if (s->missed || cx != s->wantX || cy != s->wantY || acx != s->aheadX || acy != s->aheadY)
+        prefetch(s, cx, cy, acx, acy);
+
+    int wx, wy;
+    window_at(s, cx, cy, &wx, &wy);
+    if (wx == s->winX && wy == s->winY) return false;
+
+    // not there yet: keep the old window, the camera is still inside it
+    for (int j = 0; j < STREAM_ACTIVE; j++) {
+        for (int i = 0; i < STREAM_ACTIVE; i++) {
+            if (wx + i >= s->chunksX || wy + j >= s->chunksY) continue;
+            int slot = find_slot(s, wx + i, wy + j);
+            if (slot < 0 || !SDL_GetAtomicInt(&s->slots[slot].ready)) {
+                s->waits++;
+                return false;
+            }
+        }
+    }
+
+    copy_window(s, wx, wy, tiles);
+    return true;
+}
+
+void Stream_Warm(WorldStream* s, float x, float y, TileMap* tiles)
+{
+    int wx, wy;
+    window_at(s, chunk_of(x, s->chunkPx, s->chunksX), chunk_of(y, s->chunkPx, s->chunksY), &wx, &wy);
+    while (!Stream_Update(s, x, y, x, y, tiles)) {
+        if (wx == s->winX && wy == s->winY) return;
+        SDL_Delay(1);
+    }
+}
+
+/* ------------------ generator ------------------ */
+
+static Uint32 gen_next(Uint32* st)
+{
+    Uint32 v = *st;
+    v ^= v << 13;
+    v ^= v >> 17;
+    v ^= v << 5;
+    return *st = v;
+}
+
+// 3x3 tiles around (c, r) all open, room for the biggest enemy
+static bool gen_clear(const Uint8* tiles, int c, int r)
+{
+    for (int j = r - 1; j <= r + 1; j++)
+        for (int i = c - 1; i <= c + 1; i++)
+            if (i < 0 || j < 0 || i >= CT || j >= CT || tiles[j * CT + i]) return false;
+    return true;
+}
+
+bool Stream_Generate(const char* path, int chunksX, int chunksY, float tile, Uint32 seed)
+{
+    if (chunksX < 1 || chunksY < 1 || chunksX > STREAM_MAX_CHUNKS || chunksY > STREAM_MAX_CHUNKS)
+        return false;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    int count = chunksX * chunksY;
+    WorldChunk* table = (WorldChunk*)SDL_calloc((size_t)count, sizeof(WorldChunk));
+    if (!table) {
+        fclose(f);
+        return false;
+    }
+
+    WorldHeader h = { WORLD_MAGIC, WORLD_VERSION, (Uint32)chunksX, (Uint32)chunksY, CT, tile };
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              fwrite(table, sizeof(WorldChunk), (size_t)count, f) == (size_t)count;
+
+    // tile the player starts on (Game puts it at the world centre)
+    int midC = chunksX * CT / 2, midR = chunksY * CT / 2;
+    Uint32 rng = seed ? seed : 1u;
+    Uint64 offset = sizeof(h) + sizeof(WorldChunk) * (Uint64)count;
+
+    Uint8 tiles[CT * CT];
+    WorldSpawner sp[STREAM_MAX_SPAWNERS];
+    for (int cy = 0; cy < chunksY && ok; cy++) {
+        for (int cx = 0; cx < chunksX && ok; cx++) {
+            SDL_memset(tiles, 0, sizeof(tiles));
+
+            // pillars stay 2 tiles off the chunk edge, every border is a corridor
+            int pillars = 3 + (int)(gen_next(&rng) % 6);
+            for (int k = 0; k < pillars; k++) {
+                int w = 1 + (int)(gen_next(&rng) % 4), hh = 1 + (int)(gen_next(&rng) % 4);
+                int c0 = 2 + (int)(gen_next(&rng) % (Uint32)(CT - 4 - w));
+                int r0 = 2 + (int)(gen_next(&rng) % (Uint32)(CT - 4 - hh));
+                for (int r = r0; r < r0 + hh; r++)
+                    for (int c = c0; c < c0 + w; c++) {
+                        int gc = cx * CT + c, gr = cy * CT + r;
+                        if (SDL_abs(gc - midC) > 4 || SDL_abs(gr - midR) > 4) tiles[r * CT + c] = 1;
+                    }
+            }
+
+            int n = 0;
+            int want = (int)(gen_next(&rng) % 3);
+            for (int tries = 0; n < want && tries < 16; tries++) {
+                int c = 2 + (int)(gen_next(&rng) % (CT - 4)), r = 2 + (int)(gen_next(&rng) % (CT - 4));
+                if (!gen_clear(tiles, c, r)) continue;
+                sp[n].x = (Uint16)((float)c * tile + tile * 0.5f);
+                sp[n].y = (Uint16)((float)r * tile + tile * 0.5f);
+                sp[n].type = (Uint8)(gen_next(&rng) % 4);
+                sp[n].count = (Uint8)(2 + gen_next(&rng) % 4);
+                sp[n].interval = (Uint16)(1500 + gen_next(&rng) % 3000);
+                n++;
+            }
+
+            table[cy * chunksX + cx].offset = offset;
+            table[cy * chunksX + cx].spawners = (Uint32)n;
+            ok = fwrite(tiles, sizeof(tiles), 1, f) == 1 &&
+                 (n == 0 || fwrite(sp, sizeof(WorldSpawner), (size_t)n, f) == (size_t)n);
+            offset += sizeof(tiles) + sizeof(WorldSpawner) * (size_t)n;
+        }
+    }
+
+    // offsets are known now, the table goes in after the header
+    ok = ok && fseek(f, (long)sizeof(h), SEEK_SET) == 0 &&
+         fwrite(table, sizeof(WorldChunk), (size_t)count, f) == (size_t)count;
+    ok = (fclose(f) == 0) && ok;
+    SDL_free(table);
+    return ok;
+}
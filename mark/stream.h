@@ -0,0 +1,116 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+#include "tiles.h"
+
+// worlds too big to keep in memory, streamed a chunk at a time from a
+// memory-mapped world file. only the chunks around the camera are resident,
+// the 3x3 under it is the active window the sim runs on (walls, spawners)
+
+#define STREAM_CHUNK_TILES  32      // tiles per chunk side
+#define STREAM_ACTIVE       3       // active chunks per side, centred on the camera's
+#define STREAM_RING         5       // kept resident per side around the camera
+#define STREAM_SLOTS        48      // resident chunk cap: ring, look-ahead, the old window
+#define STREAM_MAX_SPAWNERS 8       // per chunk
+#define STREAM_LOOKAHEAD    0.75f   // seconds of player movement prefetched ahead
+#define STREAM_MAX_CHUNKS   4096    // per side, a full file is ~16 GiB
+
+/* ------------------ world file ------------------ */
+
+// little endian, header, then one entry per chunk (row major), then the
+// chunk data each entry points at: tiles (1 = wall) followed by its spawners
+#define WORLD_MAGIC   0x574B524Du   // "MRKW"
+#define WORLD_VERSION 2     // 1 had 32 bit offsets, wrapped past 4 GiB
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 chunksX, chunksY;
+    Uint32 chunkTiles;      // STREAM_CHUNK_TILES
+    float tile;             // px per tile
+} WorldHeader;
+
+typedef struct {
+    Uint64 offset;          // from the start of the file
+    Uint32 spawners;
+    Uint32 pad;
+} WorldChunk;
+
+// dormant until its chunk is active, then spawns count enemies interval ms apart
+typedef struct {
+    Uint16 x, y;            // px inside the chunk
+    Uint8 type;             // EnemyType
+    Uint8 count;
+    Uint16 interval;
+} WorldSpawner;
+
+/* ------------------ resident chunks ------------------ */
+
+typedef struct {
+    float x, y;             // world position
+    int type;
+    int left;
+    float interval;
+    float timer;
+} ChunkSpawner;
+
+typedef struct {
+    int cx, cy;             // chunk held, cx < 0 = free slot
+    SDL_AtomicInt ready;    // the loader filled it in
+    bool queued;            // handed to the loader, stays put until ready
+    Uint64 used;            // last update that wanted it, oldest is reused first
+
+    Uint8 tiles[STREAM_CHUNK_TILES * STREAM_CHUNK_TILES];
+    ChunkSpawner spawners[STREAM_MAX_SPAWNERS];
+    int spawnerCount;
+} ChunkSlot;
+
+// the sim thread decides what lives in which slot, the loader thread
+// only copies chunk data out of the mapping into slots it's handed.
+// page faults on the mapping land on the loader, never on the sim
+typedef struct {
+    const Uint8* base;      // mapped file
+    size_t size;
+
+    int chunksX, chunksY;
+    float tile;
+    float chunkPx;
+
+    ChunkSlot* slots;       // STREAM_SLOTS
+
+    SDL_Thread* thread;
+    SDL_Mutex* mutex;
+    SDL_Condition* cond;
+    bool quit;
+    int queue[STREAM_SLOTS];    // slots waiting for the loader
+    int queueCount;
+
+    // active window, top-left chunk and the slot of each chunk in it
+    // (row major, -1 = past the world edge)
+    int winX, winY;
+    int active[STREAM_ACTIVE * STREAM_ACTIVE];
+
+    Uint64 tick;
+    int wantX, wantY, aheadX, aheadY;   // last prefetch, same again = nothing to do
+    bool missed;                        // a chunk found no slot, retry next update
+
+    int loads;              // chunks the loader filled
+    int waits;              // updates the window had to stay put for a chunk
+} WorldStream;
+
+// maps the file and starts the loader, false if it's missing or not a world file
+bool Stream_Open(WorldStream* s, const char* path);
+void Stream_Close(WorldStream* s);
+
+// prefetches around (x, y) and ahead of it at (ax, ay), then moves the
+// window under (x, y) once all of its chunks are resident. never waits on
+// the loader. true when the window moved, tiles then holds it
+bool Stream_Update(WorldStream* s, float x, float y, float ax, float ay, TileMap* tiles);
+// same but waits for the window's chunks, for a new run (not mid-game)
+void Stream_Warm(WorldStream* s, float x, float y, TileMap* tiles);
+
+// writes a random world of chunksX x chunksY chunks: pillars, open chunk
+// borders so every chunk connects, a clear spot in the middle for the player.
+// false for sizes Stream_Open wouldn't take (1..STREAM_MAX_CHUNKS per side)
+bool Stream_Generate(const char* path, int chunksX, int chunksY, float tile, Uint32 seed);
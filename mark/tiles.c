@@ -0,0 +1,178 @@
+#include "tiles.h"
+#include <stdio.h>
+
+bool Tiles_Load(TileMap* t, const char* path, float tile, float worldW, float worldH)
+{
+    Tiles_Free(t);
+    t->tile = tile;
+    t->ox = t->oy = 0.0f;
+    t->cols = (int)(worldW / tile) + 1;
+    t->rows = (int)(worldH / tile) + 1;
+
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    Uint8* solid = (Uint8*)SDL_calloc((size_t)(t->cols * t->rows), 1);
+    if (!solid) {
+        fclose(f);
+        return false;
+    }
+
+    int r = 0, c = 0, walls = 0;
+    for (int ch; (ch = fgetc(f)) != EOF; ) {
+        if (ch == '\n') { r++; c = 0; continue; }
+        if (ch == '\r') continue;
+        if (ch == '#' && r < t->rows && c < t->cols) {
+            solid[r * t->cols + c] = 1;
+            walls++;
+        }
+        c++;
+    }
+    fclose(f);
+
+    if (walls == 0) {
+        SDL_free(solid);
+        return true;
+    }
+    t->solid = solid;
+    t->walls = walls;
+    return true;
+}
+
+void Tiles_Free(TileMap* t)
+{
+    SDL_free(t->solid);
+    t->solid = NULL;
+    t->walls = 0;
+}
+
+/* ------------------ swept moves ------------------ */
+
+// floor/ceil of v / tile, positions can sit left of or above the map
+static int floor_div(float v, float tile)
+{
+    float q = v / tile;
+    int i = (int)q;
+    return i - (q < (float)i);
+}
+
+static int ceil_div(float v, float tile)
+{
+    float q = v / tile;
+    int i = (int)q;
+    return i + (q > (float)i);
+}
+
+// tile (i along the move, j across it)
+static bool solid_at(const TileMap* t, bool alongX, int i, int j)
+{
+    int c = alongX ? i : j;
+    int r = alongX ? j : i;
+    return t->solid[r * t->cols + c] != 0;
+}
+
+// one axis: pos/size along the move, across/span the other way.
+// walks the tile lines the leading edge crosses, nearest first
+static float sweep_axis(const TileMap* t, bool alongX, float pos, float size,
+                        float across, float span, float d, bool* hit)
+{
+    float T = t->tile;
+    int lanes = alongX ? t->rows : t->cols;
+    int lines = alongX ? t->cols : t->rows;
+
+    int j0 = SDL_max(floor_div(across, T), 0);
+    int j1 = SDL_min(ceil_div(across + span, T) - 1, lanes - 1);
+
+    if (d > 0.0f) {
+        int i0 = SDL_max(ceil_div(pos + size, T), 0);
+        int i1 = SDL_min(ceil_div(pos + size + d, T) - 1, lines - 1);
+        for (int i = i0; i <= i1; i++)
+            for (int j = j0; j <= j1; j++)
+                if (solid_at(t, alongX, i, j)) {
+                    *hit = true;
+                    return (float)i * T - size;
+                }
+    }
+    else if (d < 0.0f) {
+        int i0 = SDL_min(floor_div(pos, T) - 1, lines - 1);
+        int i1 = SDL_max(floor_div(pos + d, T), 0);
+        for (int i = i0; i >= i1; i--)
+            for (int j = j0; j <= j1; j++)
+                if (solid_at(t, alongX, i, j)) {
+                    *hit = true;
+                    return (float)(i + 1) * T;
+                }
+    }
+    return pos + d;
+}
+
+int Tiles_Move(const TileMap* t, float* x, float* y, float w, float h, float dx, float dy)
+{
+    if (!t->solid) {
+        *x += dx;
+        *y += dy;
+        return 0;
+    }
+
+    bool hitX = false, hitY = false;
+    float lx = *x - t->ox, ly = *y - t->oy;
+    lx = sweep_axis(t, true, lx, w, ly, h, dx, &hitX);
+    ly = sweep_axis(t, false, ly, h, lx, w, dy, &hitY);
+    *x = lx + t->ox;
+    *y = ly + t->oy;
+    return (hitX ? TILE_HIT_X : 0) | (hitY ? TILE_HIT_Y : 0);
+}
+
+/* ------------------ line of sight ------------------ */
+
+#define TILE_FAR 1e30f   // ray param for an axis the ray never crosses
+
+// tiles past the map edge are open
+static bool solid_tile(const TileMap* t, int c, int r)
+{
+    if (c < 0 || r < 0 || c >= t->cols || r >= t->rows) return false;
+    return t->solid[r * t->cols + c] != 0;
+}
+
+bool Tiles_Visible(const TileMap* t, float x0, float y0, float x1, float y1)
+{
+    if (!t->solid) return true;
+
+    x0 -= t->ox; y0 -= t->oy;
+    x1 -= t->ox; y1 -= t->oy;
+    float T = t->tile;
+    int c = floor_div(x0, T), r = floor_div(y0, T);
+    int steps = SDL_abs(floor_div(x1, T) - c) + SDL_abs(floor_div(y1, T) - r);
+
+    // ray param where it crosses the next column / row line, and per tile
+    float dx = x1 - x0, dy = y1 - y0;
+    int sc = dx > 0.0f ? 1 : -1;
+    int sr = dy > 0.0f ? 1 : -1;
+    float stepX = dx != 0.0f ? T / SDL_fabsf(dx) : TILE_FAR;
+    float stepY = dy != 0.0f ? T / SDL_fabsf(dy) : TILE_FAR;
+    float nextX = dx > 0.0f ? ((float)(c + 1) * T - x0) / dx
+                : dx < 0.0f ? (x0 - (float)c * T) / -dx : TILE_FAR;
+    float nextY = dy > 0.0f ? ((float)(r + 1) * T - y0) / dy
+                : dy < 0.0f ? (y0 - (float)r * T) / -dy : TILE_FAR;
+
+    for (int k = 0; k < steps; k++) {
+        if (nextX < nextY) { nextX += stepX; c += sc; }
+        else               { nextY += stepY; r += sr; }
+        if (solid_tile(t, c, r)) return false;
+    }
+    return true;
+}
+
+int Tiles_VisibleBatch(const TileMap* t, const float* x, const float* y, int n,
+                       float tx, float ty, Uint32* mask)
+{
+    SDL_memset(mask, 0, sizeof(Uint32) * (size_t)((n + 31) / 32));
+
+    int seen = 0;
+    for (int i = 0; i < n; i++) {
+        if (!Tiles_Visible(t, x[i], y[i], tx, ty)) continue;
+        mask[i >> 5] |= 1u << (i & 31);
+        seen++;
+    }
+    return seen;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+// static walls on a tile grid covering the world, one byte per tile.
+// lookups are a divide and an index, whatever the map size.
+// a streamed world only keeps a window of it here, tiles outside are open
+typedef struct {
+    float tile;
+    float ox, oy;       // world position of tile 0's corner, 0 unless streamed
+    int cols, rows;     // (int)(area / tile) + 1, same grid as the flow field
+    Uint8* solid;       // cols * rows, 1 = wall. NULL = open arena
+    int walls;          // solid tiles
+} TileMap;
+
+#define TILE_HIT_X 1
+#define TILE_HIT_Y 2
+
+// text file, one line per tile row from the top-left: '#' = wall,
+// anything else is open. rows/columns past the world are dropped,
+// missing ones stay open. false (and an open arena) when there's no file
+bool Tiles_Load(TileMap* t, const char* path, float tile, float worldW, float worldH);
+void Tiles_Free(TileMap* t);
+
+// moves the box (x, y, w, h) by (dx, dy), x first then y. each axis sweeps
+// every tile it crosses and stops flush against the first wall, so a dash
+// can't skip one. tiles the box already overlaps don't block (it can walk out)
+// returns TILE_HIT_X / TILE_HIT_Y for the axes that stopped
+int Tiles_Move(const TileMap* t, float* x, float* y, float w, float h, float dx, float dy);
+
+// line of sight (x0, y0) -> (x1, y1), DDA walk over every tile the segment
+// crosses after its first one. cost grows with the length in tiles only
+bool Tiles_Visible(const TileMap* t, float x0, float y0, float x1, float y1);
+
+// n origins against one target, bit i of mask set = origin i sees it.
+// mask needs (n + 31) / 32 words, returns how many see it
+int Tiles_VisibleBatch(const TileMap* t, const float* x, const float* y, int n,
+                       float tx, float ty, Uint32* mask);
+
+static inline bool Tiles_Solid(const TileMap* t, float x, float y)
+{
+    x -= t->ox;
+    y -= t->oy;
+    if (!t->solid || x < 0.0f || y < 0.0f) return false;
+    int c = (int)(x / t->tile);
+    int r = (int)(y / t->tile);
+    if (c >= t->cols || r >= t->rows) return false;
+    return t->solid[r * t->cols + c] != 0;
+}
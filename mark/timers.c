@@ -0,0 +1,124 @@
+#include "timers.h"
+
+static bool grow(TimerWheel* w)
+{
+    int cap = w->cap ? w->cap * 2 : 256;
+    Timer* items = (Timer*)SDL_realloc(w->items, sizeof(Timer) * (size_t)cap);
+    if (!items) return false;
+
+    // new ones go on the free list, lowest index first
+    for (int i = cap - 1; i >= w->cap; i--) {
+        items[i].next = w->free;
+        w->free = i + 1;
+    }
+    w->items = items;
+    w->cap = cap;
+    return true;
+}
+
+// lowest level whose lap holds both now and due, due's slot on it is
+// always ahead of the clock's. past the top level it waits there and gets
+// placed again every time its slot comes round
+static void place(TimerWheel* w, int i)
+{
+    Timer* t = &w->items[i - 1];
+    int l = 0;
+    while (l + 1 < TIMER_LEVELS &&
+           (t->due >> (TIMER_SLOT_BITS * (l + 1))) != (w->now >> (TIMER_SLOT_BITS * (l + 1))))
+        l++;
+
+    int s = (int)((t->due >> (TIMER_SLOT_BITS * l)) & (TIMER_SLOTS - 1));
+    t->next = w->head[l][s];
+    w->head[l][s] = i;
+}
+
+bool Timers_Add(TimerWheel* w, Uint64 due, int kind, Uint32 id, Uint32 gen)
+{
+    if (!w->free && !grow(w)) return false;
+
+    int i = w->free;
+    Timer* t = &w->items[i - 1];
+    w->free = t->next;
+
+    t->due = (due > w->now) ? due : w->now + 1;
+    t->kind = kind;
+    t->id = id;
+    t->gen = gen;
+    place(w, i);
+    w->count++;
+    return true;
+}
+
+// slot s of level l comes due, its timers move down to where they now fit
+static void cascade(TimerWheel* w, int l, int s)
+{
+    int i = w->head[l][s];
+    w->head[l][s] = 0;
+    while (i) {
+        int next = w->items[i - 1].next;
+        place(w, i);
+        i = next;
+    }
+}
+
+void Timers_Advance(TimerWheel* w, Uint64 to, TimerFn fn, void* ctx)
+{
+    while (w->now < to) {
+        // nothing waiting, no slots to walk
+        if (w->count == 0) {
+            w->now = to;
+            return;
+        }
+
+        Uint64 now = ++w->now;
+
+        // a level's lap ended: the next slot of every level above comes down,
+        // highest first so what it drops lands on slots still to be read
+        int top = 0;
+        while (top + 1 < TIMER_LEVELS && !(now & ((1ull << (TIMER_SLOT_BITS * (top + 1))) - 1)))
+            top++;
+        for (int l = top; l >= 1; l--)
+            cascade(w, l, (int)((now >> (TIMER_SLOT_BITS * l)) & (TIMER_SLOTS - 1)));
+
+        int s = (int)(now & (TIMER_SLOTS - 1));
+        int i = w->head[0][s];
+        w->head[0][s] = 0;
+        while (i) {
+            Timer t = w->items[i - 1];
+            int next = t.next;
+
+            // a lap past the top level, not this one
+            if (t.due > now) {
+                place(w, i);
+                i = next;
+                continue;
+            }
+
+            // back on the free list first, fn may reuse it
+            w->items[i - 1].next = w->free;
+            w->free = i;
+            w->count--;
+            w->fired++;
+            fn(ctx, &t);
+            i = next;
+        }
+    }
+}
+
+void Timers_Clear(TimerWheel* w, Uint64 now)
+{
+    SDL_memset(w->head, 0, sizeof(w->head));
+    w->free = 0;
+    for (int i = w->cap - 1; i >= 0; i--) {
+        w->items[i].next = w->free;
+        w->free = i + 1;
+    }
+    w->count = 0;
+    w->now = now;
+}
+
+void Timers_Free(TimerWheel* w)
+{
+    SDL_free(w->items);
+    SDL_zerop(w);
+}
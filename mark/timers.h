@@ -0,0 +1,42 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <stdbool.h>
+
+// hierarchical timer wheel on a ms clock. scheduling and firing are O(1)
+// per timer and a tick only visits the slots it passes, so the cost follows
+// the timers that come due, not how many are waiting. nothing is cancelled:
+// owners tag timers with a generation and ignore the stale ones when they fire
+#define TIMER_SLOT_BITS 8
+#define TIMER_SLOTS     (1 << TIMER_SLOT_BITS)
+#define TIMER_LEVELS    4       // 256 ms, 65 s, 4.6 h, 49 days per lap
+
+typedef struct {
+    Uint64 due;     // ms
+    Uint32 id;      // owner's slot, kind and id mean whatever the owner says
+    Uint32 gen;     // owner's generation when it was scheduled
+    int kind;
+    int next;       // 1-based, 0 = end of the list
+} Timer;
+
+typedef void (*TimerFn)(void* ctx, const Timer* t);
+
+// zeroed = empty wheel at 0 ms
+typedef struct {
+    Timer* items;
+    int cap;
+    int free;       // 1-based free list
+    int count;      // waiting to fire
+    int head[TIMER_LEVELS][TIMER_SLOTS];    // 1-based lists
+    Uint64 now;     // ms, everything due by then has fired
+
+    int fired;      // how many went off
+} TimerWheel;
+
+// fires at the first advance that reaches due, due <= now = the next advance
+bool Timers_Add(TimerWheel* w, Uint64 due, int kind, Uint32 id, Uint32 gen);
+// moves the clock to 'to', calling fn for every timer due by then, in due order
+// (same ms = any order). fn can add timers, ones due later in this advance fire in it too
+void Timers_Advance(TimerWheel* w, Uint64 to, TimerFn fn, void* ctx);
+// drops every timer and restarts the clock at 'now'
+void Timers_Clear(TimerWheel* w, Uint64 now);
+void Timers_Free(TimerWheel* w);